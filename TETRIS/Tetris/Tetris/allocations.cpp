@@ -0,0 +1,167 @@
+#include "allocations.h" // Includes the declaration of the allocation counter
+#include <atomic>  // Includes atomics so allocations on any thread are counted safely
+#include <cstdlib> // Includes malloc, aligned_alloc and free, which back the replaced operators
+#include <new>     // Includes std::bad_alloc, std::nothrow_t and std::align_val_t
+#ifdef _MSC_VER
+#include <malloc.h> // Includes _aligned_malloc and _aligned_free; MSVC has no aligned_alloc
+#endif
+
+#ifdef TETRIS_COUNT_ALLOCATIONS
+
+static std::atomic<long long> allocationCount(0); // Number of operator new calls so far
+
+// Allocates memory for the over-aligned forms (e.g. the alignas(64) worker states); null when out of memory
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed); // Count the allocation
+    std::size_t bytes = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+    return _aligned_malloc(size != 0 ? size : 1, bytes);
+#else
+    bytes = bytes < sizeof(void*) ? sizeof(void*) : bytes;
+    std::size_t rounded = (size + bytes - 1) / bytes * bytes; // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(bytes, rounded != 0 ? rounded : bytes);
+#endif
+}
+
+// Releases memory from AllocateAligned
+static void FreeAligned(void* memory)
+{
+#ifdef _MSC_VER
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+// Replaces the global operator new so every allocation is counted
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed); // Count the allocation
+    void* memory = std::malloc(size != 0 ? size : 1); // malloc(0) may return null, so always ask for a byte
+    if (memory == nullptr) // Out of memory
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size); // Arrays are counted like single objects
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed); // Count the allocation
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+// The over-aligned forms, used for types declared alignas() wider than malloc guarantees
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* memory = AllocateAligned(size, alignment);
+    if (memory == nullptr) // Out of memory
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, alignment);
+}
+
+// The matching deletes release the memory with free
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+// Over-aligned memory goes back through FreeAligned
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(memory);
+}
+
+// Returns the number of heap allocations made by the program so far
+long long GetAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+// Counting is compiled out, so there is nothing to report
+long long GetAllocationCount()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,5 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+// Test hook: returns the number of heap allocations (operator new calls, over-aligned ones included) made by the program so far
+// Counting is only compiled in when TETRIS_COUNT_ALLOCATIONS is defined; otherwise this always returns 0
+long long GetAllocationCount();
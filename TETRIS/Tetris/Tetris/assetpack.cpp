@@ -0,0 +1,207 @@
+#include "assetpack.h" // Includes the header file for the asset pack
+#include <algorithm>   // Includes sort for the directory
+#include <cstdint>     // Includes the fixed-width fields of the header
+#include <cstdio>      // Includes the file reading and writing
+#include <cstring>     // Includes memcmp for the magic bytes
+#include <filesystem>  // Includes the directory walk of the packer
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h> // Includes GetModuleFileNameA
+#else
+#include <unistd.h> // Includes readlink
+#endif
+
+static const unsigned char packMagic[4] = { 'T', 'P', 'A', 'K' }; // First bytes of every pack
+static const size_t packAlignment = 16; // Assets start on this boundary
+
+// Reads a little-endian integer of bytes bytes; returns false past the end
+static bool ReadLittleEndian(const unsigned char* data, size_t size, size_t& position, int bytes, uint64_t& value)
+{
+    if (position > size || size - position < (size_t)bytes)
+    {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value |= (uint64_t)data[position + i] << (8 * i);
+    }
+    position += bytes;
+    return true;
+}
+
+// Appends a little-endian integer of bytes bytes
+static void WriteLittleEndian(std::vector<unsigned char>& out, int bytes, uint64_t value)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out.push_back((unsigned char)(value >> (8 * i)));
+    }
+}
+
+// Maps a pack and reads its directory
+bool AssetPack::Open(const char* path)
+{
+    assets.clear();
+    if (!file.Open(path))
+    {
+        return false;
+    }
+    const unsigned char* data = file.GetData();
+    size_t size = file.GetSize();
+    size_t position = sizeof(packMagic);
+    uint64_t version = 0;
+    uint64_t count = 0;
+    if (size < sizeof(packMagic) || memcmp(data, packMagic, sizeof(packMagic)) != 0
+        || !ReadLittleEndian(data, size, position, 4, version) || version != assetPackVersion
+        || !ReadLittleEndian(data, size, position, 4, count))
+    {
+        file.Close();
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++) // Every entry must lie inside the file
+    {
+        uint64_t nameLength = 0;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        if (!ReadLittleEndian(data, size, position, 4, nameLength) || nameLength > size - position)
+        {
+            assets.clear();
+            file.Close();
+            return false;
+        }
+        PackedAsset asset;
+        asset.name.assign((const char*)data + position, (size_t)nameLength);
+        position += (size_t)nameLength;
+        if (!ReadLittleEndian(data, size, position, 8, offset) || !ReadLittleEndian(data, size, position, 8, length)
+            || offset > size || length > size - offset)
+        {
+            assets.clear();
+            file.Close();
+            return false;
+        }
+        asset.data = data + offset;
+        asset.size = (size_t)length;
+        assets.push_back(asset);
+    }
+    std::sort(assets.begin(), assets.end(), [](const PackedAsset& a, const PackedAsset& b) { return a.name < b.name; });
+    return true;
+}
+
+// Finds an asset by name with a binary search of the sorted directory
+const PackedAsset* AssetPack::Find(const char* name) const
+{
+    auto found = std::lower_bound(assets.begin(), assets.end(), name,
+        [](const PackedAsset& asset, const char* key) { return asset.name < key; });
+    return found != assets.end() && found->name == name ? &*found : nullptr;
+}
+
+// Reads a whole file; returns false if it cannot be read
+static bool ReadWholeFile(const std::string& path, std::vector<unsigned char>& bytes)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bytes.clear();
+    unsigned char buffer[65536];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+// Writes a pack of the files under each of dirs, named relative to root
+bool WriteAssetPack(const char* path, const std::string& root, const std::vector<std::string>& dirs,
+    std::vector<std::string>* packedNames)
+{
+    namespace fs = std::filesystem;
+    std::vector<std::string> names;
+    std::error_code error;
+    for (const std::string& dir : dirs)
+    {
+        fs::path base = fs::path(root) / dir;
+        for (fs::recursive_directory_iterator it(base, error), end; !error && it != end; it.increment(error))
+        {
+            if (it->is_regular_file())
+            {
+                names.push_back(fs::relative(it->path(), root).generic_string()); // Forward slashes on every system
+            }
+        }
+        if (error)
+        {
+            return false;
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    // Header and directory first, with the offsets the data will have after them
+    std::vector<std::vector<unsigned char>> contents(names.size());
+    size_t headerSize = sizeof(packMagic) + 4 + 4;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (!ReadWholeFile((fs::path(root) / names[i]).string(), contents[i]))
+        {
+            return false;
+        }
+        headerSize += 4 + names[i].size() + 8 + 8;
+    }
+    std::vector<unsigned char> out(packMagic, packMagic + sizeof(packMagic));
+    WriteLittleEndian(out, 4, assetPackVersion);
+    WriteLittleEndian(out, 4, names.size());
+    size_t offset = (headerSize + packAlignment - 1) / packAlignment * packAlignment;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        WriteLittleEndian(out, 4, names[i].size());
+        out.insert(out.end(), names[i].begin(), names[i].end());
+        WriteLittleEndian(out, 8, offset);
+        WriteLittleEndian(out, 8, contents[i].size());
+        offset = (offset + contents[i].size() + packAlignment - 1) / packAlignment * packAlignment;
+    }
+    for (size_t i = 0; i < names.size(); i++) // Then the data, padded to the boundaries
+    {
+        out.resize((out.size() + packAlignment - 1) / packAlignment * packAlignment, 0);
+        out.insert(out.end(), contents[i].begin(), contents[i].end());
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    ok = fclose(file) == 0 && ok;
+    if (ok && packedNames != nullptr)
+    {
+        packedNames->insert(packedNames->end(), names.begin(), names.end());
+    }
+    return ok;
+}
+
+// Directory of the running executable, with a trailing slash
+std::string GetExecutableDirectory()
+{
+    char path[4096];
+#ifdef _WIN32
+    DWORD length = GetModuleFileNameA(nullptr, path, sizeof(path));
+    if (length == 0 || length >= sizeof(path))
+    {
+        return "./";
+    }
+#else
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0)
+    {
+        return "./";
+    }
+#endif
+    std::string directory(path, (size_t)length);
+    size_t slash = directory.find_last_of("/\\");
+    return slash == std::string::npos ? "./" : directory.substr(0, slash + 1);
+}
@@ -0,0 +1,46 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <cstddef>        // Includes size_t for the asset sizes
+#include <string>         // Includes the asset names and paths
+#include <vector>         // Includes the directory of the pack
+#include "mappedfile.h"   // Includes the mapped file the pack is read from
+
+// Packed asset file: every font, image and sound in one file, mapped into memory and read in place
+// Layout, little-endian: "TPAK", version (uint32), asset count (uint32), then per asset its name length (uint32),
+// name (slash-separated, relative to the asset root, e.g. "Font/amm.ttf"), offset and size (uint64 each),
+// then the assets' bytes, each starting on a 16-byte boundary
+// The assets are written sorted by name with nothing else (no dates), so the same files give the same pack
+const int assetPackVersion = 1;
+
+// One asset read from a pack
+struct PackedAsset
+{
+    std::string name;
+    const unsigned char* data; // Points into the mapping
+    size_t size;
+};
+
+// A pack mapped into memory
+class AssetPack
+{
+public:
+    // Maps a pack and reads its directory; returns false if it cannot be read or is not a valid pack
+    bool Open(const char* path);
+
+    // Finds an asset by name; returns nullptr if the pack has no such asset
+    const PackedAsset* Find(const char* name) const;
+
+    int GetNumAssets() const { return (int)assets.size(); }
+    const PackedAsset& GetAsset(int index) const { return assets[index]; }
+
+private:
+    MappedFile file; // The pack's bytes
+    std::vector<PackedAsset> assets; // Directory, sorted by name
+};
+
+// Writes a pack of the files under each of dirs, named relative to root; returns false on an I/O error
+// Prints nothing; the names of the packed files are appended to packedNames if it is not null
+bool WriteAssetPack(const char* path, const std::string& root, const std::vector<std::string>& dirs,
+    std::vector<std::string>* packedNames = nullptr);
+
+// Directory of the running executable, with a trailing slash ("./" if it cannot be found)
+std::string GetExecutableDirectory();
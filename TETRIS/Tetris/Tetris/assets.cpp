@@ -0,0 +1,312 @@
+#include "assets.h" // Includes the header file for the asset manager
+#include "trace.h"  // Includes the spans of the decodes and uploads
+#include <cstdio>   // Includes the reading of loose asset files
+#include <cstring>  // Includes strrchr for the file types
+#include <algorithm> // Includes sort for the music tracks
+#include <filesystem> // Includes the listing of the loose music files
+
+// Kinds of asset, each decoded and uploaded its own way
+enum AssetKind { KIND_FONT, KIND_TEXTURE, KIND_SOUND };
+
+// Name and kind of each AssetId
+static const struct { const char* name; AssetKind kind; } assetTable[numAssets] = {
+    { "Font/amm.ttf", KIND_FONT },
+    { "Image/Tetriss.png", KIND_TEXTURE },
+    { "Image/sky.jpg", KIND_TEXTURE },
+    { "Image/pic1.jpg", KIND_TEXTURE },
+    { "Sounds/rotate.mp3", KIND_SOUND },
+    { "Sounds/clear.mp3", KIND_SOUND },
+};
+
+static const int fontSize = 64; // Size the font is rasterized at
+static const int fontGlyphCount = 95; // The printable ASCII characters
+static const int fontPadding = 4; // Space around each glyph in the atlas
+
+// File type of a name for raylib's decoders, e.g. ".png"
+static const char* FileType(const char* name)
+{
+    const char* dot = strrchr(name, '.');
+    return dot != nullptr ? dot : "";
+}
+
+// Checks whether a file exists and can be read
+static bool CanRead(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    fclose(file);
+    return true;
+}
+
+// Constructor: Finds the assets and starts the loader thread
+AssetManager::AssetManager()
+{
+    // Look next to the executable, then in the directories above it
+    std::string directory = GetExecutableDirectory();
+    root = directory;
+    hasPack = false;
+    for (int level = 0; level < 4; level++)
+    {
+        if (pack.Open((directory + "assets.pak").c_str()))
+        {
+            root = directory;
+            hasPack = true;
+            break;
+        }
+        if (CanRead(directory + assetTable[ASSET_FONT].name))
+        {
+            root = directory;
+            break;
+        }
+        directory += "../";
+    }
+
+    for (int id = 0; id < numAssets; id++)
+    {
+        decoded[id] = Decoded{};
+        states[id].store(LOAD_PENDING, std::memory_order_relaxed);
+        fonts[id] = Font{};
+        textures[id] = Texture2D{};
+        waves[id] = Wave{};
+    }
+    stopping.store(false, std::memory_order_relaxed);
+    numDone = 0;
+    startTime = GetTime();
+    thread = std::thread(&AssetManager::Run, this);
+}
+
+// Destructor: Stops the loader thread and frees what was decoded but not uploaded
+AssetManager::~AssetManager()
+{
+    stopping.store(true, std::memory_order_relaxed);
+    thread.join();
+    for (int id = 0; id < numAssets; id++)
+    {
+        if (states[id].load(std::memory_order_relaxed) == LOAD_DECODED) // Decoded, never uploaded
+        {
+            UnloadImage(decoded[id].image);
+            UnloadWave(decoded[id].wave);
+            if (decoded[id].glyphs != nullptr)
+            {
+                UnloadFontData(decoded[id].glyphs, decoded[id].glyphCount);
+                MemFree(decoded[id].recs);
+            }
+        }
+    }
+}
+
+// Finds an asset's bytes, in the pack or in a file read into storage
+bool AssetManager::Read(const char* name, std::string& storage, const unsigned char*& data, int& size) const
+{
+    if (hasPack)
+    {
+        const PackedAsset* asset = pack.Find(name);
+        if (asset == nullptr)
+        {
+            return false;
+        }
+        data = asset->data; // Read in place from the mapping
+        size = (int)asset->size;
+        return true;
+    }
+    FILE* file = fopen((root + name).c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    storage.clear();
+    char buffer[65536];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        storage.append(buffer, count);
+    }
+    fclose(file);
+    data = (const unsigned char*)storage.data();
+    size = (int)storage.size();
+    return true;
+}
+
+// Loader thread body: decodes every asset in order
+// Only CPU-side raylib calls run here; textures are created by Update on the render thread
+void AssetManager::Run()
+{
+    SetTraceThreadName("asset loader");
+    std::string storage; // Bytes of a loose file
+    for (int id = 0; id < numAssets && !stopping.load(std::memory_order_relaxed); id++)
+    {
+        TRACE_SPAN(assetTable[id].name); // Reading and decoding, on the loader's lane
+        const unsigned char* data = nullptr;
+        int size = 0;
+        bool ok = Read(assetTable[id].name, storage, data, size);
+        Decoded& result = decoded[id];
+        if (ok && assetTable[id].kind == KIND_FONT) // Rasterize the glyphs and pack them into an atlas
+        {
+            result.glyphCount = fontGlyphCount;
+            result.glyphs = LoadFontData(data, size, fontSize, nullptr, fontGlyphCount, FONT_DEFAULT);
+            ok = result.glyphs != nullptr;
+            if (ok)
+            {
+                result.image = GenImageFontAtlas(result.glyphs, &result.recs, fontGlyphCount, fontSize, fontPadding, 0);
+                for (int i = 0; i < fontGlyphCount; i++) // Glyph images cut from the atlas, as LoadFontEx does
+                {
+                    UnloadImage(result.glyphs[i].image);
+                    result.glyphs[i].image = ImageFromImage(result.image, result.recs[i]);
+                }
+            }
+        }
+        else if (ok && assetTable[id].kind == KIND_TEXTURE)
+        {
+            result.image = LoadImageFromMemory(FileType(assetTable[id].name), data, size);
+            ok = result.image.data != nullptr;
+        }
+        else if (ok && assetTable[id].kind == KIND_SOUND)
+        {
+            result.wave = LoadWaveFromMemory(FileType(assetTable[id].name), data, size);
+            ok = result.wave.data != nullptr;
+        }
+        states[id].store(ok ? LOAD_DECODED : LOAD_FAILED, std::memory_order_release); // Publishes result
+    }
+}
+
+// Uploads the assets decoded since the last call; returns true if any became ready
+bool AssetManager::Update()
+{
+    if (IsDone())
+    {
+        return false;
+    }
+    bool changed = false;
+    int done = 0;
+    for (int id = 0; id < numAssets; id++)
+    {
+        int state = states[id].load(std::memory_order_acquire);
+        if (state == LOAD_DECODED)
+        {
+            TRACE_SPAN(assetTable[id].name); // The upload, on the render thread's lane
+            Decoded& result = decoded[id];
+            if (assetTable[id].kind == KIND_FONT)
+            {
+                Font font = Font{};
+                font.baseSize = fontSize;
+                font.glyphCount = result.glyphCount;
+                font.glyphPadding = fontPadding;
+                font.glyphs = result.glyphs;
+                font.recs = result.recs;
+                font.texture = LoadTextureFromImage(result.image);
+                fonts[id] = font;
+                UnloadImage(result.image);
+            }
+            else if (assetTable[id].kind == KIND_TEXTURE)
+            {
+                textures[id] = LoadTextureFromImage(result.image);
+                UnloadImage(result.image);
+            }
+            else
+            {
+                waves[id] = result.wave; // Kept decoded for the voices made from it
+            }
+            result = Decoded{};
+            states[id].store(LOAD_READY, std::memory_order_relaxed);
+            state = LOAD_READY;
+            changed = true;
+        }
+        done += state == LOAD_READY || state == LOAD_FAILED;
+    }
+    numDone = done;
+    if (IsDone())
+    {
+        TraceLog(LOG_INFO, "ASSETS: Loaded in %.1f ms from %s%s", (GetTime() - startTime) * 1000.0, root.c_str(),
+            hasPack ? "assets.pak" : "");
+        for (int id = 0; id < numAssets; id++)
+        {
+            if (states[id].load(std::memory_order_relaxed) == LOAD_FAILED)
+            {
+                TraceLog(LOG_WARNING, "ASSETS: Could not load %s", assetTable[id].name);
+            }
+        }
+    }
+    return changed;
+}
+
+// Opens a music stream by name
+Music AssetManager::LoadMusic(const char* name) const
+{
+    if (hasPack)
+    {
+        const PackedAsset* asset = pack.Find(name);
+        if (asset == nullptr)
+        {
+            return Music{};
+        }
+        return LoadMusicStreamFromMemory(FileType(name), asset->data, (int)asset->size); // The mapping outlives it
+    }
+    return LoadMusicStream((root + name).c_str());
+}
+
+// Names of the music tracks: the files in Sounds/ other than the sound effects, sorted
+std::vector<std::string> AssetManager::ListMusic() const
+{
+    std::vector<std::string> names;
+    if (hasPack)
+    {
+        for (int i = 0; i < pack.GetNumAssets(); i++)
+        {
+            names.push_back(pack.GetAsset(i).name);
+        }
+    }
+    else
+    {
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(root + "Sounds", error), end; !error && it != end; it.increment(error))
+        {
+            names.push_back("Sounds/" + it->path().filename().generic_string());
+        }
+    }
+    std::vector<std::string> tracks;
+    for (const std::string& name : names)
+    {
+        bool isEffect = false;
+        for (int id = 0; id < numAssets; id++)
+        {
+            isEffect = isEffect || (assetTable[id].kind == KIND_SOUND && name == assetTable[id].name);
+        }
+        if (name.compare(0, 7, "Sounds/") == 0 && !isEffect)
+        {
+            tracks.push_back(name);
+        }
+    }
+    std::sort(tracks.begin(), tracks.end());
+    return tracks;
+}
+
+// Releases the textures, fonts and waves
+void AssetManager::Unload()
+{
+    for (int id = 0; id < numAssets; id++)
+    {
+        if (states[id].load(std::memory_order_relaxed) != LOAD_READY)
+        {
+            continue;
+        }
+        if (assetTable[id].kind == KIND_FONT)
+        {
+            UnloadFont(fonts[id]);
+            fonts[id] = Font{};
+        }
+        else if (assetTable[id].kind == KIND_TEXTURE)
+        {
+            UnloadTexture(textures[id]);
+            textures[id] = Texture2D{};
+        }
+        else
+        {
+            UnloadWave(waves[id]);
+            waves[id] = Wave{};
+        }
+        states[id].store(LOAD_FAILED, std::memory_order_relaxed); // Nothing left to release
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <raylib.h>    // Includes the raylib library for fonts, textures, sounds and music
+#include <atomic>      // Includes the atomic state hand-off of each asset
+#include <string>      // Includes the asset root
+#include <vector>      // Includes the list of music tracks
+#include <thread>      // Includes the loader thread
+#include "assetpack.h" // Includes the packed asset file
+
+// Assets loaded in the background
+enum AssetId
+{
+    ASSET_FONT, // Font/amm.ttf, the text of every screen
+    ASSET_MENU_BACKGROUND, // Image/Tetriss.png
+    ASSET_GAME_BACKGROUND, // Image/sky.jpg, behind the game and the pause screen
+    ASSET_HELP_IMAGE, // Image/pic1.jpg, on the "How to Play" screen
+    ASSET_ROTATE_SOUND, // Sounds/rotate.mp3
+    ASSET_CLEAR_SOUND, // Sounds/clear.mp3
+    numAssets
+};
+
+// Finds, loads and owns the game's assets, so the window opens at once and the menu shows while they load
+// The assets are found next to the executable (or up to three directories above it, for builds run from the
+// source tree): from assets.pak when there is one, built by tetris_pack, otherwise from the Font, Image and
+// Sounds directories
+// A loader thread reads and decodes them (fonts rasterized to an atlas, images and sounds decoded), and
+// Update hands the images and fonts to the GPU on the render thread
+// Until an asset is ready its getter returns an empty one, which raylib draws as nothing (or, for a font,
+// with its default font); sounds stay decoded waves, which the AudioEngine turns into voices
+class AssetManager
+{
+public:
+    AssetManager(); // Constructor: Finds the assets and starts the loader thread; call after InitWindow
+    ~AssetManager(); // Destructor: Stops the loader thread and frees what was decoded but not uploaded
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // Uploads the assets decoded since the last call; returns true if any became ready (time to redraw caches)
+    bool Update();
+
+    // Every asset is ready or failed to load
+    bool IsDone() const { return numDone == numAssets; }
+
+    Font GetFont(AssetId id) const { return fonts[id]; }
+    Texture2D GetTexture(AssetId id) const { return textures[id]; }
+    Wave GetWave(AssetId id) const { return waves[id]; } // Decoded sound; empty (no data) until ready
+
+    // Names of the music tracks: the files in Sounds/ other than the sound effects, sorted
+    std::vector<std::string> ListMusic() const;
+
+    // Opens a music stream by name (e.g. "Sounds/Weare.mp3"); streams decode as they play, so they are opened
+    // here rather than loaded in the background; returns an empty stream if the music cannot be found
+    Music LoadMusic(const char* name) const;
+
+    // Releases the textures, fonts and waves; call before closing the window
+    void Unload();
+
+    // Directory the assets are read from, with a trailing slash
+    const std::string& GetRoot() const { return root; }
+
+private:
+    // Decoded asset waiting for Update; written by the loader thread before it sets the state to LOAD_DECODED
+    struct Decoded
+    {
+        Image image; // Image, or font atlas
+        GlyphInfo* glyphs; // Font glyphs
+        Rectangle* recs; // Font glyph rectangles in the atlas
+        int glyphCount;
+        Wave wave; // Sound
+    };
+
+    enum LoadState { LOAD_PENDING, LOAD_DECODED, LOAD_READY, LOAD_FAILED };
+
+    void Run(); // Loader thread body: decodes every asset in order
+
+    // Finds an asset's bytes, in the pack or in a file read into storage; returns false if it is missing
+    bool Read(const char* name, std::string& storage, const unsigned char*& data, int& size) const;
+
+    std::string root; // Directory holding assets.pak or the asset directories
+    AssetPack pack; // The packed assets, when found
+    bool hasPack;
+    Decoded decoded[numAssets];
+    std::atomic<int> states[numAssets]; // LoadState of each asset
+    std::atomic<bool> stopping; // Tells the loader thread to exit
+    Font fonts[numAssets]; // Ready assets (only the ones of their kind are used)
+    Texture2D textures[numAssets];
+    Wave waves[numAssets];
+    int numDone; // Assets ready or failed
+    double startTime; // Time the loading started, for the log
+    std::thread thread; // Started last, once the fields above are ready
+};
@@ -0,0 +1,184 @@
+#include "audio.h" // Includes the header file for the audio engine
+#include "trace.h" // Includes the spans of the music thread
+#include <chrono>  // Includes the music thread's refill period
+
+static const float musicVolume = 3.0f; // Volume of the music (above 1 amplifies)
+static const auto musicRefillPeriod = std::chrono::milliseconds(10); // How often the music thread refills the buffer
+
+// Constructor: Opens the audio device and starts the music thread
+AudioEngine::AudioEngine(const AssetManager& assets)
+    : assets(assets)
+{
+    InitAudioDevice(); // Initialize the audio device for playing sounds and music in the application
+    for (int id = 0; id < numAssets; id++)
+    {
+        hasVoices[id] = false;
+        nextVoice[id] = 0;
+        for (Sound& voice : voices[id])
+        {
+            voice = Sound{};
+        }
+    }
+    trackNames = assets.ListMusic();
+    currentTrack = 0;
+    musicPaused = false;
+    stopping = false;
+    thread = std::thread(&AudioEngine::Run, this);
+}
+
+// Destructor: Stops the music, releases every voice and track and closes the audio device
+AudioEngine::~AudioEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join(); // The thread unloads the tracks it opened
+    for (int id = 0; id < numAssets; id++)
+    {
+        if (hasVoices[id])
+        {
+            for (Sound& voice : voices[id])
+            {
+                UnloadSound(voice);
+            }
+        }
+    }
+    CloseAudioDevice(); // Close the audio device to release audio resources
+}
+
+// Makes voices of the sound effects the AssetManager has decoded since the last call
+void AudioEngine::TakeEffects()
+{
+    for (int id = 0; id < numAssets; id++)
+    {
+        Wave wave = assets.GetWave((AssetId)id);
+        if (!hasVoices[id] && wave.data != nullptr)
+        {
+            for (Sound& voice : voices[id]) // Each voice holds its own copy of the samples, converted once
+            {
+                voice = LoadSoundFromWave(wave);
+            }
+            hasVoices[id] = true;
+        }
+    }
+}
+
+// Plays a sound effect on a free voice
+void AudioEngine::PlayEffect(AssetId id)
+{
+    if (!hasVoices[id])
+    {
+        return;
+    }
+    int voice = nextVoice[id];
+    for (int i = 0; i < voicesPerEffect; i++) // The first free voice, starting after the last one used
+    {
+        int candidate = (nextVoice[id] + i) % voicesPerEffect;
+        if (!IsSoundPlaying(voices[id][candidate]))
+        {
+            voice = candidate;
+            break;
+        }
+    }
+    PlaySound(voices[id][voice]); // With every voice busy, this restarts the oldest
+    nextVoice[id] = (voice + 1) % voicesPerEffect;
+}
+
+// Pauses or resumes the music
+void AudioEngine::SetMusicPaused(bool paused)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (musicPaused == paused)
+        {
+            return;
+        }
+        musicPaused = paused;
+    }
+    wake.notify_one();
+}
+
+// Name of the track playing
+std::string AudioEngine::GetTrackName()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tracks.empty() ? std::string() : trackNames[currentTrack];
+}
+
+// Music thread body: opens the tracks, then keeps the playing one fed
+void AudioEngine::Run()
+{
+    SetTraceThreadName("music");
+
+    // Open every track once, with larger buffers than raylib's default so a late refill never runs dry
+    // Opening only reads the headers; the samples are decoded as they play
+    TRACE_BEGIN(openSpan, "open music");
+    SetAudioStreamBufferSizeDefault(musicBufferFrames);
+    std::vector<Music> opened;
+    std::vector<std::string> names;
+    for (const std::string& name : trackNames)
+    {
+        Music music = assets.LoadMusic(name.c_str());
+        if (music.stream.buffer != nullptr) // Skip files that are not music
+        {
+            music.looping = false; // The playlist moves on instead
+            SetMusicVolume(music, musicVolume);
+            opened.push_back(music);
+            names.push_back(name);
+        }
+    }
+    SetAudioStreamBufferSizeDefault(0); // Back to raylib's default for the sound effects
+    TRACE_END(openSpan);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    tracks = opened;
+    trackNames = names;
+    bool playingPaused = false; // Whether the playing track is paused
+    if (!tracks.empty())
+    {
+        PlayMusicStream(tracks[currentTrack]);
+    }
+    while (!stopping)
+    {
+        if (!tracks.empty())
+        {
+            Music& music = tracks[currentTrack];
+            if (musicPaused != playingPaused) // Apply a pause or resume request
+            {
+                playingPaused = musicPaused;
+                if (playingPaused)
+                {
+                    PauseMusicStream(music);
+                }
+                else
+                {
+                    ResumeMusicStream(music);
+                }
+            }
+            if (!playingPaused)
+            {
+                lock.unlock(); // Decoding takes a while; requests must not wait for it
+                TRACE_BEGIN(refillSpan, "music refill");
+                UpdateMusicStream(music); // Decodes into whichever half of the ring buffer has been played
+                TRACE_END(refillSpan);
+                bool ended = !IsMusicStreamPlaying(music);
+                lock.lock();
+                if (ended) // The track played to its end: rewind it and start the next one
+                {
+                    StopMusicStream(music);
+                    currentTrack = (currentTrack + 1) % (int)tracks.size();
+                    PlayMusicStream(tracks[currentTrack]);
+                }
+            }
+        }
+        wake.wait_for(lock, musicRefillPeriod, [this] { return stopping; });
+    }
+    for (Music& music : tracks)
+    {
+        StopMusicStream(music);
+        UnloadMusicStream(music);
+    }
+    tracks.clear();
+}
@@ -0,0 +1,54 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <raylib.h>           // Includes the raylib library for the audio device, sounds and music
+#include <condition_variable> // Includes the condition variable waking the music thread
+#include <mutex>              // Includes the mutex guarding the music thread's state
+#include <string>             // Includes the track names
+#include <thread>             // Includes the music thread
+#include <vector>             // Includes the playlist
+#include "assets.h"           // Includes the asset manager the sounds and music come from
+
+const int voicesPerEffect = 4; // Copies of each sound effect, so up to this many of it can overlap
+const int musicBufferFrames = 16384; // Frames per half of each music stream's ring buffer (about 0.37 s at 44.1 kHz)
+
+// Owns the audio device, the sound effects and the music
+// Each sound effect is decoded once (by the AssetManager) and kept in memory as a pool of voices; playing an
+// effect takes a voice that is not playing, so a rotation does not cut off the one before it
+// The music streams on its own thread: every track in Sounds/ is opened once, and the thread keeps the playing
+// track's ring buffer filled, so a slow frame never starves it; when a track ends the next one starts
+class AudioEngine
+{
+public:
+    explicit AudioEngine(const AssetManager& assets); // Constructor: Opens the audio device and starts the music thread
+    ~AudioEngine(); // Destructor: Stops the music, releases every voice and track and closes the audio device
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    // Makes voices of the sound effects the AssetManager has decoded since the last call
+    void TakeEffects();
+
+    // Plays a sound effect on a free voice (or the one that started longest ago); silent until it is loaded
+    void PlayEffect(AssetId id);
+
+    // Pauses or resumes the music
+    void SetMusicPaused(bool paused);
+
+    // Name of the track playing ("" before the music thread has opened the tracks)
+    std::string GetTrackName();
+
+private:
+    void Run(); // Music thread body: opens the tracks, then keeps the playing one fed
+
+    const AssetManager& assets; // Source of the effects' waves and of the music
+    Sound voices[numAssets][voicesPerEffect]; // Voices of each effect (only the sound assets have any)
+    bool hasVoices[numAssets]; // The effect's voices were made
+    int nextVoice[numAssets]; // Voice to try first next time, round-robin
+
+    std::vector<std::string> trackNames; // The playlist, sorted
+    std::vector<Music> tracks; // The opened tracks; used only by the music thread
+    int currentTrack; // Index of the playing track
+    bool musicPaused; // Requested by SetMusicPaused
+    bool stopping; // Tells the music thread to exit
+    std::mutex mutex; // Guards currentTrack, musicPaused and stopping
+    std::condition_variable wake; // Wakes the music thread early to stop or to pause
+    std::thread thread; // Started last, once the fields above are ready
+};
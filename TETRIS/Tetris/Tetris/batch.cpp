@@ -0,0 +1,172 @@
+#include "batch.h"     // Includes the header file for the batch runner
+#include "scheduler.h" // Includes the work-stealing pool the games run on
+#include "planner.h"   // Includes the beam planner the gravity games are played with
+#include <algorithm>   // Includes std::sort for the percentiles
+#include <chrono>      // Includes the clock used to time the batch
+#include <cmath>       // Includes sqrt for the standard deviation
+#include <vector>      // Includes the containers of results and worker states
+
+// Per-thread game state, aligned to its own cache lines so workers never false-share
+struct alignas(cacheLineSize) WorkerState
+{
+    Game game; // Reused for every game the worker plays
+};
+
+// Plays one game to the end (or to maxPieces blocks) and returns its result
+static GameResult PlayGame(Game& game, unsigned int seed, Policy policy, int maxPieces)
+{
+    game.Reset(seed); // Same seed, same blocks
+    unsigned int random = seed * 2654435761u + 1u; // Policy generator
+    if (random == 0) // One seed wraps to 0, which would stall the xorshift generator
+    {
+        random = 2463534242u; // Fixed non-zero fallback
+    }
+    while (!game.gameOver && game.blocksPlaced < maxPieces)
+    {
+        policy(game, random); // Place one block
+    }
+    GameResult result;
+    result.seed = seed;
+    result.score = game.score;
+    result.lines = game.linesCleared;
+    result.pieces = game.blocksPlaced;
+    result.length = game.inputCount;
+    return result;
+}
+
+// Summarizes one statistic of the results
+static Distribution Summarize(std::vector<int>& values)
+{
+    Distribution distribution = {};
+    if (values.empty())
+    {
+        return distribution;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (int value : values)
+    {
+        sum += value;
+    }
+    distribution.mean = sum / values.size();
+    double squares = 0;
+    for (int value : values)
+    {
+        squares += (value - distribution.mean) * (value - distribution.mean);
+    }
+    distribution.stddev = std::sqrt(squares / values.size());
+    distribution.min = values.front();
+    distribution.p50 = values[values.size() * 50 / 100];
+    distribution.p90 = values[values.size() * 90 / 100];
+    distribution.p99 = values[values.size() * 99 / 100];
+    distribution.max = values.back();
+    return distribution;
+}
+
+// Plays one game per seed with the given policy, spread over the workers with work stealing
+BatchResults RunBatch(unsigned int firstSeed, long long numGames, Policy policy, int numWorkers, int maxPieces)
+{
+    WorkStealingPool pool(numWorkers);
+    std::vector<WorkerState> workers(pool.GetNumWorkers()); // One isolated game per thread
+    std::vector<GameResult> results((size_t)numGames); // Each game writes only its own slot
+
+    auto start = std::chrono::steady_clock::now();
+    pool.ParallelFor(numGames, 16, [&](long long index, int worker)
+    {
+        results[(size_t)index] = PlayGame(workers[worker].game, firstSeed + (unsigned int)index, policy, maxPieces);
+    });
+    auto end = std::chrono::steady_clock::now();
+
+    BatchResults batch = {};
+    batch.games = numGames;
+    batch.seconds = std::chrono::duration<double>(end - start).count();
+    batch.workers = pool.GetNumWorkers();
+
+    std::vector<int> values((size_t)numGames);
+    for (size_t i = 0; i < results.size(); i++) { values[i] = results[i].score; }
+    batch.score = Summarize(values);
+    for (size_t i = 0; i < results.size(); i++) { values[i] = results[i].lines; }
+    batch.lines = Summarize(values);
+    for (size_t i = 0; i < results.size(); i++) { values[i] = results[i].pieces; batch.totalPieces += results[i].pieces; }
+    batch.pieces = Summarize(values);
+    for (size_t i = 0; i < results.size(); i++) { values[i] = results[i].length; }
+    batch.length = Summarize(values);
+    return batch;
+}
+
+// The shortest gravity interval CalculationInterval gives at any score
+double FastestGravityInterval()
+{
+    double fastest = CalculationInterval(0);
+    for (int score = 0; score <= 100000; score++) // Well past the score where the interval stops shrinking
+    {
+        double interval = CalculationInterval(score);
+        fastest = interval < fastest ? interval : fastest;
+    }
+    return fastest;
+}
+
+// Plays one game per seed, one after another, with the planner under gravity
+GravityResults RunGravityGames(unsigned int firstSeed, long long numGames, double gravitySeconds, int numWorkers, int maxPieces)
+{
+    const double frameSeconds = 1.0 / 90.0; // The game's target frame rate
+    PlannerSettings settings = defaultPlannerSettings;
+    settings.numWorkers = numWorkers;
+    BeamPlanner planner(settings);
+    GravityResults results = {};
+    results.gravitySeconds = gravitySeconds;
+    std::vector<double> latencies; // Of every decision, in milliseconds
+    std::vector<int> scores;
+    Game game;
+    GameInput inputs[maxMoveStates];
+    for (long long index = 0; index < numGames; index++)
+    {
+        game.Reset(firstSeed + (unsigned int)index);
+        double gravityTime = 0; // Game time since the last gravity tick
+        // Passes game time, moving the block down at every gravity tick
+        auto passTime = [&](double seconds) {
+            results.simulatedSeconds += seconds;
+            gravityTime += seconds;
+            while (gravityTime >= gravitySeconds && !game.gameOver)
+            {
+                gravityTime -= gravitySeconds;
+                game.MoveBlockDown();
+            }
+        };
+        while (!game.gameOver && game.blocksPlaced < maxPieces)
+        {
+            int placed = game.blocksPlaced;
+            auto start = std::chrono::steady_clock::now();
+            int numInputs = planner.Think(game, inputs, maxMoveStates);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            results.decisions++;
+            latencies.push_back(seconds * 1000);
+            results.missedDeadlines += seconds > gravitySeconds ? 1 : 0;
+            results.missedFrames += seconds > frameSeconds ? 1 : 0;
+            passTime(seconds); // The block keeps falling while the planner thinks
+            if (numInputs == 0) // Nothing fits; dropping ends the game
+            {
+                game.ApplyInput(INPUT_DROP);
+            }
+            int applied = 0; // Inputs applied before the block locked
+            while (applied < numInputs && game.blocksPlaced == placed && !game.gameOver)
+            {
+                game.ApplyInput(inputs[applied++]);
+                passTime(frameSeconds); // One input per frame
+            }
+            results.lostBlocks += applied < numInputs ? 1 : 0; // Gravity locked it before the final drop
+        }
+        results.games++;
+        results.pieces += game.blocksPlaced;
+        scores.push_back(game.score);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    if (!latencies.empty())
+    {
+        results.p50Ms = latencies[latencies.size() * 50 / 100];
+        results.p99Ms = latencies[latencies.size() * 99 / 100];
+        results.maxMs = latencies.back();
+    }
+    results.score = Summarize(scores);
+    return results;
+}
@@ -0,0 +1,67 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include "policy.h" // Includes the Policy type the games are played with
+
+// Outcome of one simulated game
+struct GameResult
+{
+    unsigned int seed; // Seed of the game's block sequence
+    int score; // Final score
+    int lines; // Rows cleared
+    int pieces; // Blocks placed
+    int length; // Inputs applied
+};
+
+// Summary of one statistic over all games of a batch
+struct Distribution
+{
+    double mean;
+    double stddev;
+    int min;
+    int p50; // Median
+    int p90;
+    int p99;
+    int max;
+};
+
+// Aggregate results of a batch
+struct BatchResults
+{
+    long long games; // Number of games played
+    long long totalPieces; // Blocks placed over all games
+    double seconds; // Wall-clock time of the batch
+    int workers; // Number of threads that played
+    Distribution score;
+    Distribution lines;
+    Distribution pieces;
+    Distribution length;
+};
+
+// Plays one game per seed in [firstSeed, firstSeed + numGames) with the given policy, spread over
+// numWorkers threads (0 = every core) with work stealing; games stop after maxPieces blocks
+BatchResults RunBatch(unsigned int firstSeed, long long numGames, Policy policy, int numWorkers, int maxPieces);
+
+// Aggregate results of games played by the planner under gravity
+struct GravityResults
+{
+    long long games; // Number of games played
+    long long pieces; // Blocks placed over all games
+    long long decisions; // Decisions the planner made
+    long long missedDeadlines; // Decisions that took longer than one gravity interval: the block had already fallen
+    long long missedFrames; // Decisions that took longer than one 90 FPS frame
+    long long lostBlocks; // Blocks gravity locked before their decision's inputs were all applied
+    double gravitySeconds; // Gravity interval the games were played at
+    double simulatedSeconds; // Game time: the decisions' real latency plus one frame per input
+    double p50Ms; // Decision latency percentiles, in milliseconds
+    double p99Ms;
+    double maxMs;
+    Distribution score;
+};
+
+// The shortest gravity interval CalculationInterval gives at any score
+double FastestGravityInterval();
+
+// Plays one game per seed, one after another, the way autoplay plays them but under gravity: the planner decides
+// with its default time budget on numWorkers threads (0 = every core), the decision's real latency passes as game
+// time, then its inputs are applied one per 90 FPS frame; gravity moves the block down every gravitySeconds of
+// game time throughout, so a late decision finds its block lower, or already locked
+GravityResults RunGravityGames(unsigned int firstSeed, long long numGames, double gravitySeconds, int numWorkers, int maxPieces);
@@ -0,0 +1,31 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+#include <cstdint> // Includes the fixed-width integer types used for the row masks
+
+// Bitmask of the occupied cells in one row of the board
+// Bit (column + wallWidth) is set when the cell in that column is filled
+typedef uint16_t RowMask;
+
+// Number of always-set "wall" bits on each side of the playfield columns
+// A piece shifted into a wall collides with it, so one AND covers both the side bounds and the stack
+const int wallWidth = 3;
+
+// Counts the set bits of a row mask
+inline int CountBits(RowMask mask)
+{
+    unsigned int bits = mask; // Parallel bit count on 16 bits
+    bits = bits - ((bits >> 1) & 0x5555u);
+    bits = (bits & 0x3333u) + ((bits >> 2) & 0x3333u);
+    bits = (bits + (bits >> 4)) & 0x0F0Fu;
+    return (int)((bits + (bits >> 8)) & 0x1Fu);
+}
+
+// Index of the lowest set bit of a nonzero mask, for row masks of any width up to 32 bits
+inline int LowestBitIndex(uint32_t mask)
+{
+    uint32_t bits = (mask & (0u - mask)) - 1; // Every bit below the lowest set one
+    bits = bits - ((bits >> 1) & 0x55555555u);
+    bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0Fu;
+    return (int)((bits * 0x01010101u) >> 24);
+}
@@ -3,30 +3,28 @@
 // Constructor: Initializes a Block object with default values
 Block::Block()
 {
-    cellSize = 30; // Sets the size of each cell in the block (e.g., 30x30 pixels)
     rotationState = 0; // Initializes the block's rotation state to 0 (default orientation)
-    colors = GetCellColors(); // Retrieves the predefined colors for blocks
     rowOffset = 0; // Sets the initial vertical offset of the block on the grid
     columnOffset = 0; // Sets the initial horizontal offset of the block on the grid
     id = 0; // Initializes the block's ID to a default value (e.g., 0)
 }
 
+// Constructor: Creates a block of the given type at its spawn position
+Block::Block(int id)
+{
+    this->id = id; // Selects the block's row in the piece table
+    rotationState = 0; // Starts in the default orientation
+    rowOffset = pieceShapes[id].spawnRow; // Adjust the block's initial position
+    columnOffset = pieceShapes[id].spawnColumn;
+}
 
-// Draws the block on the screen at the specified offset
-void Block::Draw(int offsetX, int offsetY)
+// Constructor: Creates a block at a given placement (e.g. one found by the move generator)
+Block::Block(int id, int rotationState, int rowOffset, int columnOffset)
 {
-    std::vector<Position> tiles = GetCellPositions(); // Gets the current positions of the block's cells
-    for (Position item : tiles) // Iterates through each cell in the block
-    {
-        // Draws a rectangle for each cell at its calculated position
-        DrawRectangle(
-            item.column * cellSize + offsetX, // X-coordinate of the rectangle
-            item.row * cellSize + offsetY,   // Y-coordinate of the rectangle
-            cellSize - 1,                    // Width of the rectangle (slightly smaller for spacing)
-            cellSize - 1,                    // Height of the rectangle (slightly smaller for spacing)
-            colors[id]                       // Color of the rectangle based on the block's ID
-        );
-    }
+    this->id = id;
+    this->rotationState = rotationState;
+    this->rowOffset = rowOffset;
+    this->columnOffset = columnOffset;
 }
 
 // Moves the block by the specified number of rows and columns
@@ -36,60 +34,32 @@ void Block::Move(int rows, int columns)
     columnOffset += columns; // Adjusts the horizontal offset by the specified number of columns
 }
 
-// Returns the current positions of the block's cells on the grid
-std::vector<Position> Block::GetCellPositions()
+// Fills the current positions of the block's four cells on the grid (no allocation)
+void Block::GetCellPositions(Position tiles[4]) const
 {
-    std::vector<Position> tiles = cells[rotationState]; // Gets the cell positions for the current rotation state
-    std::vector<Position> movedTiles; // Stores the adjusted positions of the cells
-    for (Position item : tiles) // Iterates through each cell in the block
+    const PieceRotation& rotation = GetRotation(); // Gets the cell positions for the current rotation state
+    for (int i = 0; i < 4; i++) // Iterates through each cell in the block
     {
         // Adjusts the cell's position based on the block's offsets
-        Position newPos = Position(item.row + rowOffset, item.column + columnOffset);
-        movedTiles.push_back(newPos); // Adds the adjusted position to the list
+        tiles[i] = Position(rotation.cells[i].row + rowOffset, rotation.cells[i].column + columnOffset);
     }
-    return movedTiles; // Returns the adjusted positions of the block's cells
 }
 
 // Rotates the block to the next rotation state
 void Block::Rotate()
 {
     rotationState++; // Advances to the next rotation state
-    if (rotationState == (int)cells.size()) // If the rotation state exceeds the number of states
+    if (rotationState == pieceShapes[id].numRotations) // If the rotation state exceeds the number of states
     {
         rotationState = 0; // Wraps around to the first rotation state
     }
 }
-void Block::Draw(int offsetX, int offsetY, int rectWidth, int rectHeight)
-{
-    // Calculate the total width and height of the block based on its cells
-    int blockWidth = cellSize * 4;  // Assuming a maximum of 4 cells wide
-    int blockHeight = cellSize * 4; // Assuming a maximum of 4 cells tall
-
-    // Calculate the centering offsets within the rectangle
-    int centerX = offsetX + (rectWidth - blockWidth) / 2;
-    int centerY = offsetY + (rectHeight - blockHeight) / 2;
-
-    // Get the current positions of the block's cells
-    std::vector<Position> tiles = GetCellPositions();
-    for (Position item : tiles)
-    {
-        // Draw each cell of the block, adjusted for centering
-        DrawRectangle(
-            item.column * cellSize + centerX, // X-coordinate of the rectangle
-            item.row * cellSize + centerY,   // Y-coordinate of the rectangle
-            cellSize - 1,                    // Width of the rectangle (slightly smaller for spacing)
-            cellSize - 1,                    // Height of the rectangle (slightly smaller for spacing)
-            colors[id]                       // Color of the rectangle based on the block's ID
-        );
-    }
-}
-
 // Undoes the last rotation, returning the block to its previous state
 void Block::UndoRotation()
 {
     rotationState--; // Reverts to the previous rotation state
     if (rotationState == -1) // If the rotation state goes below 0
     {
-        rotationState = cells.size() - 1; // Wraps around to the last rotation state
+        rotationState = pieceShapes[id].numRotations - 1; // Wraps around to the last rotation state
     }
 }
@@ -1,26 +1,22 @@
 #pragma once // Ensures the header file is included only once during compilation
 
-#include <vector> // Includes the vector container for managing collections of positions and colors
-#include <map>    // Includes the map container for managing rotation states and their corresponding cell positions
 #include "position.h" // Includes the Position class for defining cell positions
-#include "colors.h"   // Includes the Color struct for managing block colors
+#include "pieces.h"   // Includes the compile-time table of block shapes and rotations
 
+// A block is a small value type: its shape comes from the constant pieceShapes table,
+// so constructing or copying one never touches the heap
 class Block
 {
 public:
-    Block(); // Constructor: Initializes a Block object
-
-    // Draws the block on the screen at the specified offset
-    void Draw(int offsetX, int offsetY);
-
-    // Overloaded Draw method: Draws the block centered within a rectangle
-    void Draw(int offsetX, int offsetY, int rectWidth, int rectHeight);
+    Block(); // Constructor: Initializes an empty Block object
+    explicit Block(int id); // Constructor: Creates a block of the given type at its spawn position
+    Block(int id, int rotationState, int rowOffset, int columnOffset); // Constructor: Creates a block at a given placement
 
     // Moves the block by the specified number of rows and columns
     void Move(int rows, int columns);
 
-    // Returns the current positions of the block's cells on the grid
-    std::vector<Position> GetCellPositions();
+    // Fills the current positions of the block's four cells on the grid (no allocation)
+    void GetCellPositions(Position tiles[4]) const;
 
     // Rotates the block to the next rotation state
     void Rotate();
@@ -28,18 +24,23 @@ public:
     // Undoes the last rotation, returning the block to its previous state
     void UndoRotation();
 
-    int id; // Unique identifier for the block type (e.g., LBlock, JBlock, etc.)
+    // Returns one mask per local row of the current rotation (bit = local column)
+    const RowMask* GetRowMasks() const { return GetRotation().rowMasks; }
 
-    // Maps rotation states (0, 1, 2, 3) to the corresponding cell positions
-    std::map<int, std::vector<Position>> cells;
+    // Returns the table entry of the current rotation state
+    const PieceRotation& GetRotation() const { return pieceShapes[id].rotations[rotationState]; }
 
-    // Getter for colors
-    const std::vector<Color>& GetColors() const { return colors; }
+    // Returns the current rotation state (0 to numRotations - 1)
+    int GetRotationState() const { return rotationState; }
+
+    // Getters for the block's offsets on the grid
+    int GetRowOffset() const { return rowOffset; }
+    int GetColumnOffset() const { return columnOffset; }
+
+    int id; // Unique identifier for the block type (e.g., LBlock, JBlock, etc.)
 
 private:
-    int cellSize; // The size of each cell in the block (e.g., width and height in pixels)
     int rotationState; // The current rotation state of the block (0, 1, 2, or 3)
-    std::vector<Color> colors; // The colors associated with the block
     int rowOffset; // The block's vertical offset on the grid
     int columnOffset; // The block's horizontal offset on the grid
 };
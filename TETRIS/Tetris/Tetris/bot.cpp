@@ -0,0 +1,174 @@
+#include "bot.h" // Includes the header file for the bot
+#include <chrono> // Includes the clock measuring the bot's latency
+#include "trace.h" // Includes the span of a decision
+
+// Constructor: Uses the default weights
+Bot::Bot()
+{
+    weights = defaultBotWeights;
+}
+
+// Scores the batched boards, empties the batch and returns the best of the scores and bestScore
+double Bot::ScoreBest(double bestScore)
+{
+    EvaluateBatch(batch, features);
+    ScoreBatch(batch, features, weights, scores);
+    for (int board = 0; board < batch.count; board++)
+    {
+        bestScore = scores[board] > bestScore ? scores[board] : bestScore;
+    }
+    batch.count = 0;
+    return bestScore;
+}
+
+// Finds the best placement of the current block and writes its inputs, ending with INPUT_DROP
+int Bot::Think(const Game& game, GameInput inputs[], int capacity)
+{
+    int numPlacements = current.Generate(game.GetGrid(), game.GetCurrentBlock());
+    if (numPlacements == 0) // Nothing fits; the game is about to end
+    {
+        return 0;
+    }
+    double bestScore = 0;
+    int best = 0;
+    for (int i = 0; i < numPlacements; i++) // Every placement of the current block
+    {
+        Game child = game; // Games are plain values, so trying a placement is a copy
+        child.PlaceBlock(current.GetPlacedBlock(i));
+        int childLines = child.linesCleared - game.linesCleared;
+        double score = -1e9; // Topping out is the worst outcome
+        if (!child.gameOver)
+        {
+            // The child's current block is the game's next block, so look one block further
+            int numNext = next.Generate(child.GetGrid(), child.GetCurrentBlock());
+            score = numNext == 0 ? EvaluateBoard(child.GetGrid(), childLines, weights) : -1e9;
+            batch.count = 0;
+            for (int j = 0; j < numNext; j++)
+            {
+                Game grandchild = child;
+                grandchild.PlaceBlock(next.GetPlacedBlock(j));
+                if (grandchild.gameOver)
+                {
+                    continue;
+                }
+                batch.Add(grandchild.GetGrid(), grandchild.linesCleared - game.linesCleared);
+                if (batch.count == boardBatchSize) // Score each full batch
+                {
+                    score = ScoreBest(score);
+                }
+            }
+            if (batch.count > 0) // Score the boards left over
+            {
+                score = ScoreBest(score);
+            }
+        }
+        if (i == 0 || score > bestScore) // Keep the best placement
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return current.GetPath(best, inputs, capacity);
+}
+
+// Constructor: Starts the thread
+BotThread::BotThread(const PlannerSettings& settings)
+    : planner(settings)
+{
+    tickets = 0;
+    hasRequest = false;
+    hasResult = false;
+    stopping = false;
+    result.ticket = 0;
+    result.numInputs = 0;
+    result.seconds = 0;
+    result.depth = 0;
+    thread = std::thread(&BotThread::Run, this);
+}
+
+// Destructor: Stops and joins the thread
+BotThread::~BotThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+// Asks for a decision on a copy of the game; replaces a request the thread has not started yet
+int BotThread::Request(const Game& game)
+{
+    int ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        request = game; // A plain copy of a few hundred bytes
+        ticket = ++tickets;
+        hasRequest = true;
+    }
+    wake.notify_one();
+    return ticket;
+}
+
+// Copies the latest decision and returns true if one arrived since the last call
+bool BotThread::TakeDecision(BotDecision& decision)
+{
+    std::lock_guard<std::mutex> lock(mutex); // The thread holds the lock only to copy, never while thinking
+    if (!hasResult)
+    {
+        return false;
+    }
+    decision.ticket = result.ticket;
+    decision.numInputs = result.numInputs;
+    decision.seconds = result.seconds;
+    decision.depth = result.depth;
+    for (int i = 0; i < result.numInputs; i++) // Only the inputs in use
+    {
+        decision.inputs[i] = result.inputs[i];
+    }
+    hasResult = false;
+    return true;
+}
+
+// Thread body: waits for requests and thinks
+void BotThread::Run()
+{
+    SetTraceThreadName("bot");
+    Game game; // The thread's own copy of the requested game
+    int ticket = 0; // Ticket of the request being answered
+    BotDecision decision; // Built outside the lock, then published
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return hasRequest || stopping; });
+            if (stopping)
+            {
+                return;
+            }
+            game = request;
+            ticket = tickets;
+            hasRequest = false;
+        }
+
+        TRACE_SPAN("bot decision"); // One span for the whole search
+        TRACE_MUTE(); // Not one per block the search locks on this thread; the planner mutes its pool workers
+        auto start = std::chrono::steady_clock::now();
+        decision.ticket = ticket;
+        decision.numInputs = planner.Think(game, decision.inputs, maxMoveStates);
+        decision.depth = planner.GetLastDepth();
+        decision.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        result.ticket = decision.ticket;
+        result.numInputs = decision.numInputs;
+        result.seconds = decision.seconds;
+        result.depth = decision.depth;
+        for (int i = 0; i < decision.numInputs; i++)
+        {
+            result.inputs[i] = decision.inputs[i];
+        }
+        hasResult = true;
+    }
+}
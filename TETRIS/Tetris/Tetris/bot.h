@@ -0,0 +1,76 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <condition_variable> // Includes the condition variable waking the bot's thread
+#include <mutex>              // Includes the mutex guarding the hand-off between the threads
+#include <thread>             // Includes the bot's worker thread
+#include "evaluator.h"        // Includes the board features and their weights
+#include "movegen.h"          // Includes the move generator and the game rules
+#include "planner.h"          // Includes the beam planner the bot thread decides with
+
+// Heuristic player: tries every reachable placement of the current block, and of the next block after it,
+// and keeps the current placement with the best board two blocks ahead
+// The boards two blocks ahead are scored sixteen at a time by the batch evaluator
+// Holds its generators and batch, so thinking never allocates
+class Bot
+{
+public:
+    Bot(); // Constructor: Uses the default weights
+
+    // Finds the best placement of the current block and writes its inputs, ending with INPUT_DROP
+    // Returns the number of inputs, or 0 if the block cannot be placed anywhere
+    int Think(const Game& game, GameInput inputs[], int capacity);
+
+    BotWeights weights; // Weights of the board features
+
+private:
+    // Scores the batched boards, empties the batch and returns the best of the scores and bestScore
+    double ScoreBest(double bestScore);
+
+    MoveGenerator current; // Placements of the current block
+    MoveGenerator next; // Placements of the next block, after each placement of the current one
+    BoardBatch batch; // Boards two blocks ahead waiting to be scored
+    BoardFeatures features; // Features of the batch's boards
+    double scores[boardBatchSize]; // Scores of the batch's boards
+};
+
+// One decision of the bot: the inputs for one block
+struct BotDecision
+{
+    int ticket; // Number returned by the request it answers; decisions for older requests are stale
+    int numInputs; // Number of inputs; 0 if the block fits nowhere
+    double seconds; // Time the bot spent thinking
+    int depth; // Blocks the search looked ahead
+    GameInput inputs[maxMoveStates]; // The inputs, ending with INPUT_DROP
+};
+
+// Runs a BeamPlanner on its own thread so the caller (the render loop) never waits for a search
+// The planner keeps to its time budget, so decisions arrive at a steady rate however fast the game runs
+// The caller posts a copy of the game and polls for the decision on later frames
+class BotThread
+{
+public:
+    explicit BotThread(const PlannerSettings& settings = defaultPlannerSettings); // Constructor: Starts the thread
+    ~BotThread(); // Destructor: Stops and joins the thread
+    BotThread(const BotThread&) = delete;
+    BotThread& operator=(const BotThread&) = delete;
+
+    // Asks for a decision on a copy of the game; replaces a request the thread has not started yet
+    // Returns the ticket the decision will carry
+    int Request(const Game& game);
+
+    // Copies the latest decision and returns true if one arrived since the last call; never waits for the search
+    bool TakeDecision(BotDecision& decision);
+
+private:
+    void Run(); // Thread body: waits for requests and thinks
+
+    BeamPlanner planner; // The player, used only by the thread
+    Game request; // Latest game posted by the caller
+    BotDecision result; // Latest decision of the thread
+    int tickets; // Number of requests so far
+    bool hasRequest; // A request is waiting for the thread
+    bool hasResult; // A decision is waiting for the caller
+    bool stopping; // Tells the thread to exit
+    std::mutex mutex; // Guards the fields above; held only to copy them, never while thinking
+    std::condition_variable wake; // Signals the thread that a request arrived or that it must stop
+    std::thread thread; // Started last, once the fields above are ready
+};
@@ -13,10 +13,18 @@ const Color cyan = { 21, 204, 209, 255 };     // A cyan color, possibly for the
 const Color blue = { 13, 64, 216, 255 };      // A blue color, possibly for the JBlock
 const Color lightBlue = { 59, 85, 162, 255 }; // A lighter blue, likely used for UI elements or highlights
 const Color darkBlue = { 44, 44, 127, 255 };  // A dark blue, possibly used for the background
+const Color garbageGrey = { 110, 110, 110, 255 }; // The cells of garbage rows
 
 // Returns a vector of colors for use in the game, likely for coloring Tetris blocks
 std::vector<Color> GetCellColors()
 {
     // The order of colors in this vector may correspond to block types (e.g., LBlock, JBlock, etc.)
-    return { black, green, red, orange, yellow, purple, cyan, blue };
+    return { black, green, red, orange, yellow, purple, cyan, blue, garbageGrey };
+}
+
+// Returns the color of a single cell or block ID without building the whole vector
+const Color& GetCellColor(int id)
+{
+    static const Color cellColors[] = { black, green, red, orange, yellow, purple, cyan, blue, garbageGrey }; // Same order as GetCellColors
+    return cellColors[id];
 }
\ No newline at end of file
@@ -15,7 +15,11 @@ extern const Color cyan;       // A cyan color, possibly for the IBlock
 extern const Color blue;       // A blue color, possibly for the JBlock
 extern const Color lightBlue;  // A lighter blue, likely used for UI elements or highlights
 extern const Color darkBlue;   // A dark blue, possibly used for the background
+extern const Color garbageGrey; // The cells of garbage rows
 
 // Function declaration for retrieving a collection of colors
 // Returns a vector of colors, likely used for assigning colors to Tetris blocks
-std::vector<Color> GetCellColors();
\ No newline at end of file
+std::vector<Color> GetCellColors();
+
+// Returns the color of a single cell or block ID without building the whole vector
+const Color& GetCellColor(int id);
\ No newline at end of file
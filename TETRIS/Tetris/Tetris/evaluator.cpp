@@ -0,0 +1,282 @@
+#include "evaluator.h" // Includes the header file for the board evaluators
+#include <cstring>     // Includes memset for clearing the batch
+
+// The AVX2 kernel is compiled on x86 with GCC, Clang or MSVC and picked at run time,
+// so the same binary still runs on processors without AVX2
+#if !defined(TETRIS_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TETRIS_AVX2_KERNEL 1
+#define TETRIS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif !defined(TETRIS_NO_SIMD) && defined(_MSC_VER) && defined(_M_X64)
+#define TETRIS_AVX2_KERNEL 1
+#define TETRIS_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#define TETRIS_AVX2_KERNEL 0
+#endif
+
+// Bits of the playfield columns
+static const RowMask playfieldMask = (RowMask)(((1 << batchColumns) - 1) << wallWidth);
+// Columns that have a playfield column on their right (pairs for bumpiness)
+static const RowMask neighbourMask = (RowMask)(((1 << (batchColumns - 1)) - 1) << wallWidth);
+// Cells that have a cell on their right, from the left wall to the last column (pairs for row transitions)
+static const RowMask transitionMask = (RowMask)(((1 << (batchColumns + 1)) - 1) << (wallWidth - 1));
+// Bit-sliced counters need this many planes to count up to batchRows
+static const int heightPlanes = 5;
+static_assert((1 << heightPlanes) > batchRows, "the height counters must count up to batchRows");
+
+// Scores one board after a placement; higher is better
+double EvaluateBoard(const Grid& grid, int linesCleared, const BotWeights& weights)
+{
+    RowMask playfield = (RowMask)~grid.GetEmptyRow(); // Bits of the playfield columns
+    int heights[16] = { 0 }; // Height of each column, indexed by its bit
+    int holes = 0; // Empty cells with a filled cell above them
+    int rowTransitions = 0; // Filled/empty changes along the rows
+    RowMask seen = 0; // Columns that have a filled cell above the current row
+    for (int row = 0; row < grid.GetNumRows(); row++) // Scan from the top
+    {
+        RowMask cells = grid.rows[row] & playfield; // Filled cells of the row without the walls
+        RowMask tops = cells & (RowMask)~seen; // Columns whose highest cell is on this row
+        while (tops != 0)
+        {
+            int bit = CountBits((RowMask)((tops & -tops) - 1)); // Index of the lowest set bit
+            heights[bit] = grid.GetNumRows() - row;
+            tops &= (RowMask)(tops - 1);
+        }
+        holes += CountBits(seen & (RowMask)~cells); // Empty cells under a filled one
+        rowTransitions += CountBits((RowMask)((grid.rows[row] ^ (grid.rows[row] >> 1)) & transitionMask));
+        seen |= cells;
+    }
+
+    int aggregateHeight = 0;
+    int bumpiness = 0;
+    int wells = 0;
+    int numCols = grid.GetNumCols();
+    for (int column = 0; column < numCols; column++)
+    {
+        int height = heights[column + wallWidth];
+        aggregateHeight += height;
+        int left = column > 0 ? heights[column + wallWidth - 1] : grid.GetNumRows(); // Walls count as full columns
+        int right = column + 1 < numCols ? heights[column + wallWidth + 1] : grid.GetNumRows();
+        if (column + 1 < numCols)
+        {
+            bumpiness += height > right ? height - right : right - height;
+        }
+        int rim = left < right ? left : right; // The lower neighbour bounds the well
+        if (rim > height)
+        {
+            wells += rim - height;
+        }
+    }
+    return weights.aggregateHeight * aggregateHeight + weights.holes * holes + weights.bumpiness * bumpiness
+        + weights.wells * wells + weights.lines * linesCleared + weights.rowTransitions * rowTransitions;
+}
+
+// Constructor: Starts empty, with every slot zeroed
+BoardBatch::BoardBatch()
+{
+    memset(rows, 0, sizeof(rows)); // The kernels scan every slot, so none may be left uninitialized
+    memset(lines, 0, sizeof(lines));
+    count = 0;
+}
+
+// Copies a board into the next free slot; returns false when the batch is full
+bool BoardBatch::Add(const Grid& grid, int linesCleared)
+{
+    if (count == boardBatchSize)
+    {
+        return false;
+    }
+    for (int row = 0; row < batchRows; row++)
+    {
+        rows[row][count] = grid.rows[row];
+    }
+    lines[count] = (short)linesCleared;
+    count++;
+    return true;
+}
+
+// Scalar kernel: the same scan as the AVX2 kernel, one board at a time
+void EvaluateBatchScalar(const BoardBatch& batch, BoardFeatures& features)
+{
+    for (int board = 0; board < boardBatchSize; board++)
+    {
+        RowMask seen = 0; // Cells covered by a filled cell at or above the current row, walls included
+        RowMask planes[heightPlanes] = { 0 }; // Bit-sliced counters of the covered rows of each column
+        int aggregateHeight = 0;
+        int maxHeight = 0;
+        int holes = 0;
+        int bumpiness = 0;
+        int wells = 0;
+        int rowTransitions = 0;
+        for (int row = 0; row < batchRows; row++) // Scan from the top
+        {
+            RowMask cells = batch.rows[row][board];
+            holes += CountBits(seen & (RowMask)~cells); // Covered empty cells
+            seen |= cells;
+            RowMask covered = seen & playfieldMask;
+            aggregateHeight += CountBits(covered); // Every covered cell adds one to its column's height
+            maxHeight += covered != 0;
+            bumpiness += CountBits((RowMask)((seen ^ (seen >> 1)) & neighbourMask)); // Covered next to uncovered
+            wells += CountBits((RowMask)(~seen & (seen << 1) & (seen >> 1) & playfieldMask)); // Uncovered between covered
+            rowTransitions += CountBits((RowMask)((cells ^ (cells >> 1)) & transitionMask));
+            RowMask carry = covered; // Add one to the counters of the covered columns
+            for (int plane = 0; plane < heightPlanes; plane++)
+            {
+                RowMask next = planes[plane] & carry;
+                planes[plane] ^= carry;
+                carry = next;
+            }
+        }
+        features.aggregateHeight[board] = (short)aggregateHeight;
+        features.maxHeight[board] = (short)maxHeight;
+        features.holes[board] = (short)holes;
+        features.bumpiness[board] = (short)bumpiness;
+        features.wells[board] = (short)wells;
+        features.rowTransitions[board] = (short)rowTransitions;
+        for (int column = 0; column < batchColumns; column++)
+        {
+            int height = 0;
+            for (int plane = 0; plane < heightPlanes; plane++)
+            {
+                height |= ((planes[plane] >> (column + wallWidth)) & 1) << plane;
+            }
+            features.heights[column][board] = (unsigned char)height;
+        }
+    }
+}
+
+#if TETRIS_AVX2_KERNEL
+// Counts the set bits of each 16-bit lane with a nibble lookup table
+TETRIS_TARGET_AVX2 static inline __m256i PopCount16(__m256i value)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbles = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(value, nibbles));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(value, 4), nibbles));
+    __m256i bytes = _mm256_add_epi8(low, high); // Bits per byte
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0x00FF)), _mm256_srli_epi16(bytes, 8));
+}
+
+// AVX2 kernel: the scalar kernel's scan on all sixteen boards at once, one 16-bit lane per board
+TETRIS_TARGET_AVX2 void EvaluateBatchAvx2(const BoardBatch& batch, BoardFeatures& features)
+{
+    const __m256i playfield = _mm256_set1_epi16((short)playfieldMask);
+    const __m256i neighbours = _mm256_set1_epi16((short)neighbourMask);
+    const __m256i transitions = _mm256_set1_epi16((short)transitionMask);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    __m256i seen = zero;
+    __m256i planes[heightPlanes] = { zero, zero, zero, zero, zero };
+    __m256i aggregateHeight = zero;
+    __m256i maxHeight = zero;
+    __m256i holes = zero;
+    __m256i bumpiness = zero;
+    __m256i wells = zero;
+    __m256i rowTransitions = zero;
+    for (int row = 0; row < batchRows; row++) // Scan from the top
+    {
+        __m256i cells = _mm256_loadu_si256((const __m256i*)batch.rows[row]);
+        holes = _mm256_add_epi16(holes, PopCount16(_mm256_andnot_si256(cells, seen))); // Covered empty cells
+        seen = _mm256_or_si256(seen, cells);
+        __m256i covered = _mm256_and_si256(seen, playfield);
+        aggregateHeight = _mm256_add_epi16(aggregateHeight, PopCount16(covered));
+        maxHeight = _mm256_add_epi16(maxHeight, _mm256_andnot_si256(_mm256_cmpeq_epi16(covered, zero), one));
+        __m256i right = _mm256_srli_epi16(seen, 1); // Each cell's right neighbour
+        __m256i left = _mm256_slli_epi16(seen, 1); // Each cell's left neighbour
+        bumpiness = _mm256_add_epi16(bumpiness, PopCount16(_mm256_and_si256(_mm256_xor_si256(seen, right), neighbours)));
+        wells = _mm256_add_epi16(wells, PopCount16(_mm256_and_si256(_mm256_andnot_si256(seen, _mm256_and_si256(left, right)), playfield)));
+        rowTransitions = _mm256_add_epi16(rowTransitions,
+            PopCount16(_mm256_and_si256(_mm256_xor_si256(cells, _mm256_srli_epi16(cells, 1)), transitions)));
+        __m256i carry = covered; // Add one to the counters of the covered columns
+        for (int plane = 0; plane < heightPlanes; plane++)
+        {
+            __m256i next = _mm256_and_si256(planes[plane], carry);
+            planes[plane] = _mm256_xor_si256(planes[plane], carry);
+            carry = next;
+        }
+    }
+    _mm256_storeu_si256((__m256i*)features.aggregateHeight, aggregateHeight);
+    _mm256_storeu_si256((__m256i*)features.maxHeight, maxHeight);
+    _mm256_storeu_si256((__m256i*)features.holes, holes);
+    _mm256_storeu_si256((__m256i*)features.bumpiness, bumpiness);
+    _mm256_storeu_si256((__m256i*)features.wells, wells);
+    _mm256_storeu_si256((__m256i*)features.rowTransitions, rowTransitions);
+    for (int column = 0; column < batchColumns; column++) // Read each column's counter out of the planes
+    {
+        __m128i shift = _mm_cvtsi32_si128(column + wallWidth);
+        __m256i height = zero;
+        for (int plane = 0; plane < heightPlanes; plane++)
+        {
+            __m256i bit = _mm256_and_si256(_mm256_srl_epi16(planes[plane], shift), one);
+            height = _mm256_or_si256(height, _mm256_sll_epi16(bit, _mm_cvtsi32_si128(plane)));
+        }
+        short lanes[boardBatchSize];
+        _mm256_storeu_si256((__m256i*)lanes, height);
+        for (int board = 0; board < boardBatchSize; board++)
+        {
+            features.heights[column][board] = (unsigned char)lanes[board];
+        }
+    }
+}
+
+// Checks once whether this build and processor can run the AVX2 kernel
+static bool DetectAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0; // CPUID.7.0:EBX.AVX2
+    __cpuid(info, 1);
+    bool osSaves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6; // The OS saves the YMM registers
+    return avx2 && osSaves;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#else
+// Without the AVX2 kernel the scalar one stands in
+void EvaluateBatchAvx2(const BoardBatch& batch, BoardFeatures& features)
+{
+    EvaluateBatchScalar(batch, features);
+}
+
+static bool DetectAvx2()
+{
+    return false;
+}
+#endif
+
+// Checks once whether this build and processor can run the AVX2 kernel
+bool IsAvx2Available()
+{
+    static const bool available = DetectAvx2(); // Detected on first use
+    return available;
+}
+
+// Computes the features of every board of a batch, with AVX2 when the processor has it
+void EvaluateBatch(const BoardBatch& batch, BoardFeatures& features)
+{
+    if (IsAvx2Available())
+    {
+        EvaluateBatchAvx2(batch, features);
+    }
+    else
+    {
+        EvaluateBatchScalar(batch, features);
+    }
+}
+
+// Combines the features and cleared rows of each board of a batch into scores, like EvaluateBoard
+void ScoreBatch(const BoardBatch& batch, const BoardFeatures& features, const BotWeights& weights, double scores[])
+{
+    for (int board = 0; board < batch.count; board++) // Same terms in the same order as EvaluateBoard
+    {
+        scores[board] = weights.aggregateHeight * features.aggregateHeight[board] + weights.holes * features.holes[board]
+            + weights.bumpiness * features.bumpiness[board] + weights.wells * features.wells[board]
+            + weights.lines * batch.lines[board] + weights.rowTransitions * features.rowTransitions[board];
+    }
+}
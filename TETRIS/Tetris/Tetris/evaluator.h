@@ -0,0 +1,67 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include "grid.h" // Includes the Grid and its bitboard rows
+
+// Weights of the board features placements are scored with
+struct BotWeights
+{
+    double aggregateHeight; // Sum of the column heights
+    double holes; // Empty cells with a filled cell above them
+    double bumpiness; // Sum of the height differences between neighbouring columns
+    double wells; // Total depth of the columns lower than both neighbours (or a neighbour and a wall)
+    double lines; // Rows cleared by the placements
+    double rowTransitions; // Filled/empty changes along the rows, walls included
+};
+
+// Weights tuned for the classic four features, with a light penalty on wells
+const BotWeights defaultBotWeights = { -0.510066, -0.35663, -0.184483, -0.1, 0.760666, 0.0 };
+
+// Scores one board after a placement; higher is better
+// The per-board reference for the batch evaluator below
+double EvaluateBoard(const Grid& grid, int linesCleared, const BotWeights& weights);
+
+const int boardBatchSize = 16; // Boards per batch: one 16-bit lane of a 256-bit register each
+const int batchRows = Grid::numRows; // Rows of a Grid
+const int batchColumns = Grid::numCols; // Columns of a Grid
+
+// Candidate boards in structure-of-arrays layout: row r of every board side by side,
+// so one vector load brings the same row of all the boards
+struct BoardBatch
+{
+    RowMask rows[batchRows][boardBatchSize]; // Bitboard rows, walls included
+    short lines[boardBatchSize]; // Rows cleared to reach each board
+    int count; // Boards in use
+
+    BoardBatch(); // Constructor: Starts empty, with every slot zeroed
+
+    // Copies a board into the next free slot; returns false when the batch is full
+    // Set count to 0 to reuse the batch; the kernels also scan the unused slots, which keep old boards
+    bool Add(const Grid& grid, int linesCleared);
+};
+
+// Features of every board of a batch, also in structure-of-arrays layout
+struct BoardFeatures
+{
+    short aggregateHeight[boardBatchSize];
+    short maxHeight[boardBatchSize]; // Height of the tallest column
+    short holes[boardBatchSize];
+    short bumpiness[boardBatchSize];
+    short wells[boardBatchSize];
+    short rowTransitions[boardBatchSize];
+    unsigned char heights[batchColumns][boardBatchSize]; // Height of each column
+};
+
+// Computes the features of every board of a batch with one OR-scan down the rows:
+// once a column is covered it stays covered, so counting covered cells per row gives heights,
+// covered empty cells give holes, and covered cells next to uncovered ones give bumpiness and wells
+// Uses AVX2 when the processor has it, the scalar kernel otherwise
+void EvaluateBatch(const BoardBatch& batch, BoardFeatures& features);
+
+// The two kernels, for benchmarks and tests; both compute the same features
+void EvaluateBatchScalar(const BoardBatch& batch, BoardFeatures& features);
+void EvaluateBatchAvx2(const BoardBatch& batch, BoardFeatures& features); // Only call when IsAvx2Available()
+
+// Checks once whether this build and processor can run the AVX2 kernel
+bool IsAvx2Available();
+
+// Combines the features and cleared rows of each board of a batch into scores, like EvaluateBoard
+void ScoreBatch(const BoardBatch& batch, const BoardFeatures& features, const BotWeights& weights, double scores[]);
@@ -1,56 +1,29 @@
 #include "game.h"
-#include <random> // Allows generating random numbers
-#include <iostream> // For logging drop positions
+#include "trace.h" // Includes the spans of the drop, lock and line clear
 
 // Constructor: Initializes the game state and resources
 Game::Game()
 {
     grid = Grid(); // Initializes the grid member variable of the Game class
-    blocks = GetAllBlocks(); // The blocks vector is used to store all the possible Tetris block types
+    bag.Seed(1); // Default sequence; Reset(seed) picks another one
+    queue.Fill(bag); // Deal the upcoming blocks
     currentBlock = GetRandomBlock(); // Assigns a randomly selected block to the currentBlock variable
-    nextBlock = GetRandomBlock(); // Start a random dropping block
     gameOver = false; // Indicating the game is not over and gameplay can continue
     score = 0; // This is typically done to reset the player's score at the start of the game or after a game reset
-    InitAudioDevice(); // Initialize the audio device for playing sounds and music in the application
-
-    // Load background music tracks
-     music = LoadMusicStream("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetris-game-main/TETRIS/Tetris/Sounds/Weare.mp3"); // Background Music While Playing
-     music = LoadMusicStream("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetris-game-main/TETRIS/Tetris/Sounds/Bunny.mp3"); // Background Music While Playing
-     music = LoadMusicStream("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetris-game-main/TETRIS/Tetris/Sounds/Otonoke.mp3"); // Background Music While Playing
-    PlayMusicStream(music); // Used to start playing a music stream
-    SetMusicVolume(music, 3.0f); // Set the volume of the music
-
-    // Load sound effects
-    rotateSound = LoadSound("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetris-game-main/TETRIS/Tetris/Sounds/rotate.mp3"); // Sound effect while rotating the block
-    clearSound = LoadSound("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetris-game-main/TETRIS/Tetris/Sounds/clear.mp3"); // Sound effect when the block clears
-}
-
-// Destructor: Cleans up resources when the game ends
-Game::~Game()
-{
-    UnloadSound(rotateSound); // Unload the sound effect for block rotation
-    UnloadSound(clearSound); // Unload the sound effect for clearing rows
-    UnloadMusicStream(music); // Unload the background music stream
-    CloseAudioDevice(); // Close the audio device to release audio resources
+    events = 0; // No rotations or row clears have happened yet
+    linesCleared = 0; // Nothing has been played yet
+    blocksPlaced = 0;
+    inputCount = 0;
+    garbageSent = 0; // No garbage has been exchanged yet
+    pendingGarbage = 0;
+    garbageSeed = 1;
+    garbageRandom.Seed(garbageSeed);
 }
 
-// Returns a random block from the available blocks
+// Takes the next block from the queue
 Block Game::GetRandomBlock()
 {
-    if (blocks.empty()) // If the blocks vector is empty
-    {
-        blocks = GetAllBlocks(); // Refill the blocks vector with all block types
-    }
-    int randomIndex = rand() % blocks.size(); // Generate a random index
-    Block block = blocks[randomIndex]; // Select the block at the random index
-    blocks.erase(blocks.begin() + randomIndex); // Remove the selected block from the vector
-    return block; // Return the selected block
-}
-
-// Returns a vector containing all possible Tetris block types
-std::vector<Block> Game::GetAllBlocks()
-{
-    return { IBlock(), JBlock(), LBlock(), OBlock(), SBlock(), TBlock(), ZBlock() }; // All block types
+    return Block(queue.Pop(bag)); // The queue deals from the seeded bag and stays full
 }
 
 // Swaps the current block with the next block
@@ -58,113 +31,113 @@ void Game::SwapNextBlockWithCurrent()
 {
     if (!gameOver) // Only allow swapping if the game is not over
     {
-        std::swap(currentBlock, nextBlock); // Swap the current block with the next block
+        int nextId = queue.Peek(0); // The block waiting at the front of the queue
+        queue.Replace(0, currentBlock.id); // Put the current block back in its place
+        currentBlock = Block(nextId); // Swap the current block with the next block
     }
 }
 
-// Draws a rectangle with a stroke
-void DrawRectangleWithStroke(Rectangle rect, Color fillColor, Color strokeColor, float strokeThickness)
+// Resets the game state
+void Game::Reset()
 {
-    // Draw the stroke (outer rectangle)
-    DrawRectangle(
-        rect.x - strokeThickness, // Adjust position for stroke
-        rect.y - strokeThickness,
-        rect.width + 2 * strokeThickness, // Increase size for stroke
-        rect.height + 2 * strokeThickness,
-        strokeColor // Stroke color
-    );
-
-    // Draw the inner rectangle (fill)
-    DrawRectangle(
-        rect.x, // Original position
-        rect.y,
-        rect.width, // Original size
-        rect.height,
-        fillColor // Fill color
-    );
+    grid = Grid(); // Reset the grid
+    queue = PieceQueue(); // Deal a new queue, continuing the bag's sequence
+    queue.Fill(bag);
+    currentBlock = GetRandomBlock(); // Reset the current block
+    gameOver = false; // Reset the game over state
+    score = 0; // Reset the score
+    events = 0; // Drop any events that were not handled yet
+    linesCleared = 0; // Reset the statistics
+    blocksPlaced = 0;
+    inputCount = 0;
+    garbageSent = 0; // Drop the garbage of the last game
+    pendingGarbage = 0;
+    garbageRandom.Seed(garbageSeed); // The holes never depend on how far the last game got
 }
 
-// Draws the game grid, current block, and next block
-void Game::Draw()
+// Resets the game state and restarts the block sequence for the seed
+void Game::Reset(uint64_t seed)
 {
-    grid.Draw(); // Draw the game grid
-
-    // Draw the current block
-    std::vector<Position> blockCells = currentBlock.GetCellPositions();
-    for (Position cell : blockCells)
-    {
-        int x = cell.column * grid.GetCellSize() + 11;
-        int y = cell.row * grid.GetCellSize() + 11;
-
-        DrawRectangleWithStroke(
-            { static_cast<float>(x), static_cast<float>(y), static_cast<float>(grid.GetCellSize() - 1), static_cast<float>(grid.GetCellSize() - 1) },
-            currentBlock.GetColors()[currentBlock.id],
-            WHITE,
-            2.0f
-        );
-    }
+    bag.Seed(seed); // Games with the same seed get the same blocks on every platform
+    garbageSeed = seed ^ 0x6761726261676521ull; // And the same garbage holes, from a sequence of their own
+    Reset();
+}
 
-    // Draw the next block in the "next rectangle" position
-    if (nextBlock.id != 0) // Ensure there is a next block to draw
-    {
-        // Define the "next rectangle" dimensions
-        int nextRectX = 270; // X-coordinate of the rectangle
-        int nextRectY = 220; // Y-coordinate of the rectangle
-        int nextRectWidth = 120; // Width of the rectangle
-        int nextRectHeight = 120; // Height of the rectangle
+// Replaces the board, keeping the blocks; the game is over if the current block no longer fits
+void Game::LoadGrid(const Grid& board)
+{
+    grid = board; // Grids are plain values
+    gameOver = !BlockFits(); // A board reaching into the spawn area ends the game
+}
 
-        // Use the centering version of the Draw method
-        nextBlock.Draw(nextRectX, nextRectY, nextRectWidth, nextRectHeight);
-    }
+// Copies the game's state into a snapshot
+void Game::Save(GameSnapshot& snapshot) const
+{
+    snapshot.grid = grid;
+    snapshot.bag = bag;
+    snapshot.queue = queue;
+    snapshot.currentBlock = currentBlock;
+    snapshot.garbageRandom = garbageRandom;
+    snapshot.garbageSeed = garbageSeed;
+    snapshot.score = score;
+    snapshot.linesCleared = linesCleared;
+    snapshot.blocksPlaced = blocksPlaced;
+    snapshot.inputCount = inputCount;
+    snapshot.garbageSent = garbageSent;
+    snapshot.pendingGarbage = pendingGarbage;
+    snapshot.gameOver = gameOver;
 }
 
-// Resets the game state
-void Game::Reset()
+// Returns the game to a saved state; the events raised since the snapshot belong to moves that were undone
+void Game::Restore(const GameSnapshot& snapshot)
 {
-    grid = Grid(); // Reset the grid
-    blocks = GetAllBlocks(); // Refill the blocks vector
-    currentBlock = GetRandomBlock(); // Reset the current block
-    nextBlock = GetRandomBlock(); // Reset the next block
-    gameOver = false; // Reset the game over state
-    score = 0; // Reset the score
+    grid = snapshot.grid;
+    bag = snapshot.bag;
+    queue = snapshot.queue;
+    currentBlock = snapshot.currentBlock;
+    garbageRandom = snapshot.garbageRandom;
+    garbageSeed = snapshot.garbageSeed;
+    score = snapshot.score;
+    linesCleared = snapshot.linesCleared;
+    blocksPlaced = snapshot.blocksPlaced;
+    inputCount = snapshot.inputCount;
+    garbageSent = snapshot.garbageSent;
+    pendingGarbage = snapshot.pendingGarbage;
+    gameOver = snapshot.gameOver;
+    events = 0;
 }
 
-// Handles player input for controlling the game
-void Game::HandleInput()
+// Zobrist hash of the position a search sees: board, current block and queue
+uint64_t Game::GetHash() const
 {
-    int keyPressed = GetKeyPressed(); // Get the key pressed by the player
-    if (gameOver && keyPressed != 0) // If the game is over and any key is pressed
+    uint64_t hash = grid.GetHash() ^ zobristKeys.currentBlock[currentBlock.id];
+    for (int slot = 0; slot < queue.GetSize(); slot++)
     {
-        gameOver = false; // Reset the game state
+        hash ^= zobristKeys.queuedBlocks[slot][queue.Peek(slot)];
     }
-    switch (keyPressed) // Handle specific key presses
+    return hash;
+}
+
+// Applies one input to the current block without allocating
+void Game::ApplyInput(GameInput input)
+{
+    inputCount++; // Every input counts towards the game's length
+    switch (input)
     {
-    case KEY_A:
-        MoveBlockLeft(); // Move the current block left
+    case INPUT_LEFT:
+        MoveBlockLeft();
         break;
-    case KEY_D:
-        MoveBlockRight(); // Move the current block right
+    case INPUT_RIGHT:
+        MoveBlockRight();
         break;
-    case KEY_S:
-        MoveBlockDown(); // Move the current block down
+    case INPUT_DOWN:
+        MoveBlockDown();
         break;
-    case KEY_W:
-        RotateBlock(); // Rotate the current block
+    case INPUT_ROTATE:
+        RotateBlock();
         break;
-    case KEY_SPACE:
-        Dropblock(); // Drops the blocks automatically
-        break;
-    case KEY_LEFT:
-        MoveBlockLeft(); // Move the current block left
-        break;
-    case KEY_RIGHT:
-        MoveBlockRight(); // Move the current block right
-        break;
-    case KEY_DOWN:
-        MoveBlockDown(); // Move the current block down
-        break;
-    case KEY_UP:
-        RotateBlock(); // Rotate the current block
+    case INPUT_DROP:
+        Dropblock();
         break;
     }
 }
@@ -172,15 +145,49 @@ void Game::HandleInput()
 // Drops the current block to the bottom of the grid
 void Game::Dropblock()
 {
-    while (!gameOver) // Keep moving the block down until it locks
+    if (!gameOver) // Only allow dropping if the game is not over
     {
-        currentBlock.Move(1, 0); // Move the block down
-        if (IsBlockOutside() || BlockFits() == false) // If the block is outside the grid or doesn't fit
+        TRACE_SPAN("Dropblock");
+        currentBlock.Move(GetDropDistance(), 0); // Jump straight to the landing row
+        LockBlock(); // Lock the block into the grid
+    }
+}
+
+// Returns how many rows the current block can fall before it lands
+// Each column of the block lands one row above the column's top, so the distance is the smallest gap;
+// a block already below a column's top (tucked under an overhang) falls back to stepping down one row at a time
+int Game::GetDropDistance() const
+{
+    const PieceRotation& rotation = currentBlock.GetRotation();
+    int rowOffset = currentBlock.GetRowOffset();
+    int columnOffset = currentBlock.GetColumnOffset();
+    int distance = grid.GetNumRows(); // More than any block can fall
+    for (int column = rotation.minColumn; column <= rotation.maxColumn; column++) // Each column the block covers
+    {
+        int bottom = rowOffset + rotation.bottoms[column]; // Lowest cell of the block in this column
+        int top = grid.GetColumnTop(columnOffset + column); // Highest filled cell below it, if the block is above the stack
+        if (bottom >= top) // Under an overhang: the column's top does not bound the fall
         {
-            currentBlock.Move(-1, 0); // Undo the last move
-            LockBlock(); // Lock the block into the grid
-            break; // Exit the loop
+            int steps = 0;
+            while (grid.PieceFits(rowOffset + steps + 1, columnOffset, rotation.rowMasks))
+            {
+                steps++;
+            }
+            return steps;
         }
+        distance = top - 1 - bottom < distance ? top - 1 - bottom : distance;
+    }
+    return distance;
+}
+
+// Locks a placement of the current block without replaying its inputs
+// The caller makes sure the placement is reachable, e.g. by taking it from the move generator
+void Game::PlaceBlock(const Block& block)
+{
+    if (!gameOver) // Only allow placing if the game is not over
+    {
+        currentBlock = block; // Jump straight to the placement
+        LockBlock(); // Lock the block into the grid
     }
 }
 
@@ -190,7 +197,7 @@ void Game::MoveBlockLeft()
     if (!gameOver) // Only allow movement if the game is not over
     {
         currentBlock.Move(0, -1); // Move the block left
-        if (IsBlockOutside() || BlockFits() == false) // If the block is outside the grid or doesn't fit
+        if (BlockFits() == false) // If the block is outside the grid or doesn't fit
         {
             currentBlock.Move(0, 1); // Undo the movement
         }
@@ -203,7 +210,7 @@ void Game::MoveBlockRight()
     if (!gameOver) // Only allow movement if the game is not over
     {
         currentBlock.Move(0, 1); // Move the block right
-        if (IsBlockOutside() || BlockFits() == false) // If the block is outside the grid or doesn't fit
+        if (BlockFits() == false) // If the block is outside the grid or doesn't fit
         {
             currentBlock.Move(0, -1); // Undo the movement
         }
@@ -216,7 +223,7 @@ void Game::MoveBlockDown()
     if (!gameOver) // Only allow movement if the game is not over
     {
         currentBlock.Move(1, 0); // Move the block down
-        if (IsBlockOutside() || BlockFits() == false) // If the block is outside the grid or doesn't fit
+        if (BlockFits() == false) // If the block is outside the grid or doesn't fit
         {
             currentBlock.Move(-1, 0); // Undo the movement
             LockBlock(); // Lock the block into the grid
@@ -224,33 +231,19 @@ void Game::MoveBlockDown()
     }
 }
 
-// Checks if the current block is outside the grid
-bool Game::IsBlockOutside()
-{
-    std::vector<Position> tiles = currentBlock.GetCellPositions(); // Get the positions of the block's cells
-    for (Position item : tiles) // Iterate through each cell
-    {
-        if (grid.IsCellOutside(item.row, item.column)) // Check if the cell is outside the grid
-        {
-            return true; // Block is outside
-        }
-    }
-    return false; // Block is inside
-}
-
 // Rotates the current block
 void Game::RotateBlock()
 {
     if (!gameOver) // Only allow rotation if the game is not over
     {
         currentBlock.Rotate(); // Rotate the block
-        if (IsBlockOutside() || BlockFits() == false) // If the block is outside the grid or doesn't fit
+        if (BlockFits() == false) // If the block is outside the grid or doesn't fit
         {
             currentBlock.UndoRotation(); // Undo the rotation
         }
         else
         {
-            PlaySound(rotateSound); // Play the rotation sound effect
+            events |= EVENT_ROTATED; // Let the presentation layer play the rotation sound
         }
     }
 }
@@ -258,37 +251,84 @@ void Game::RotateBlock()
 // Locks the current block into the grid and spawns the next block
 void Game::LockBlock()
 {
-    std::vector<Position> tiles = currentBlock.GetCellPositions(); // Get the positions of the block's cells
+    TRACE_SPAN("LockBlock");
+    Position tiles[4]; // The positions of the block's cells
+    currentBlock.GetCellPositions(tiles);
     for (Position item : tiles) // Iterate through each cell
     {
-        grid.grid[item.row][item.column] = currentBlock.id; // Lock the cell into the grid
+        grid.SetCell(item.row, item.column, currentBlock.id); // Lock the cell into the grid
     }
-    currentBlock = nextBlock; // Set the next block as the current block
+    blocksPlaced++; // Count the placement
+    currentBlock = GetRandomBlock(); // Set the next block as the current block
     if (BlockFits() == false) // If the new block doesn't fit
     {
         gameOver = true; // End the game
     }
-    nextBlock = GetRandomBlock(); // Spawn a new random block
     int rowsCleared = grid.ClearFullRows(); // Clear any full rows
     if (rowsCleared > 0) // If rows were cleared
     {
-        PlaySound(clearSound); // Play the row clear sound effect
+        events |= EVENT_ROWS_CLEARED; // Let the presentation layer play the row clear sound
         UpdateScore(rowsCleared, 0); // Update the score based on the rows cleared
+        linesCleared += rowsCleared; // Count the cleared rows
     }
+    ExchangeGarbage(rowsCleared);
 }
 
-// Checks if the current block fits in the grid
-bool Game::BlockFits()
+// Sends garbage for a clear, after cancelling what was queued against it; a lock without a clear lets the
+// queued garbage rise instead, in one shift of the whole board
+// Outside versus play nothing is ever queued, so only garbageSent changes and nobody takes it
+void Game::ExchangeGarbage(int rowsCleared)
 {
-    std::vector<Position> tiles = currentBlock.GetCellPositions(); // Get the positions of the block's cells
-    for (Position item : tiles) // Iterate through each cell
+    if (gameOver) // The lock topped out: a lost board neither sends nor takes garbage
     {
-        if (grid.IsCellEmpty(item.row, item.column) == false) // If the cell is not empty
+        return;
+    }
+    int attack = garbageForClear[rowsCleared];
+    int cancelled = attack < pendingGarbage ? attack : pendingGarbage; // A clear first blocks incoming rows
+    pendingGarbage -= cancelled;
+    garbageSent += attack - cancelled;
+    if (rowsCleared == 0 && pendingGarbage > 0)
+    {
+        int holeColumn = garbageRandom.NextBelow(grid.GetNumCols()); // One hole column per attack, so it can be dug out
+        if (!grid.AddGarbageRows(pendingGarbage, holeColumn, GARBAGE_CELL) || BlockFits() == false)
         {
-            return false; // Block doesn't fit
+            gameOver = true; // Pushed over the top, or into the spawned block
         }
+        pendingGarbage = 0;
+    }
+}
+
+// Checks in one pass that the current block is inside the grid and on empty cells
+bool Game::BlockFits()
+{
+    // AND the block's precomputed rows for its current rotation against the grid's rows;
+    // the grid's wall bits and row bounds reject blocks outside the grid in the same pass
+    return grid.PieceFits(currentBlock.GetRowOffset(), currentBlock.GetColumnOffset(), currentBlock.GetRowMasks());
+}
+
+// Returns and clears the events raised since the last call
+int Game::TakeEvents()
+{
+    int raised = events; // Events raised since the last call
+    events = 0; // Each event is reported once
+    return raised;
+}
+
+// Returns and clears the garbage rows sent since the last call
+int Game::TakeGarbage()
+{
+    int sent = garbageSent;
+    garbageSent = 0; // Each row is sent once
+    return sent;
+}
+
+// Queues garbage rows from an opponent
+void Game::ReceiveGarbage(int rows)
+{
+    if (!gameOver)
+    {
+        pendingGarbage += rows;
     }
-    return true; // Block fits
 }
 
 // Updates the player's score based on lines cleared and move down points
@@ -311,3 +351,11 @@ void Game::UpdateScore(int linesCleared, int moveDownPoints)
 
 
 }
+
+// Calculates the gravity interval based on the score
+double CalculationInterval(int score)
+{
+    // Base interval is 0.8 seconds, decrease as score increases
+    double interval = 0.8 - (score / 1000.0); // Adjust the divisor to control speed scaling
+    return interval > 0.2 ? interval : 0.32;  // Ensure a minimum interval of 0.5 seconds
+}
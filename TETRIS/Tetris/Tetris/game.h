@@ -1,39 +1,115 @@
 #pragma once // Ensures the header file is included only once during compilation
 #include "grid.h" // Includes the Grid class, which represents the Tetris game board
-#include "blocks.cpp" // Includes the implementation of blocks (Tetris pieces)
+#include "block.h" // Includes the Block class and the table of Tetris pieces
+#include "randomizer.h" // Includes the seeded 7-bag generator and the queue of upcoming blocks
+#include <type_traits> // Includes is_trivially_copyable for the snapshot's check
 
+// Player inputs understood by the game, shared by the keyboard and scripted callers
+enum GameInput
+{
+    INPUT_LEFT,   // Moves the current block one column to the left
+    INPUT_RIGHT,  // Moves the current block one column to the right
+    INPUT_DOWN,   // Moves the current block one row down (locking it when it lands)
+    INPUT_ROTATE, // Rotates the current block
+    INPUT_DROP    // Drops the current block to the bottom and locks it
+};
+
+// Events raised by the rules for the presentation layer (sounds, effects), combined as bit flags
+enum GameEvent
+{
+    EVENT_ROTATED = 1,      // The current block was rotated
+    EVENT_ROWS_CLEARED = 2  // One or more rows were cleared
+};
+
+// Everything that decides how a game goes on: board, current block, queue, generators, score and counters
+// Trivially copyable and free of pointers, so saving or restoring one is a fixed-size copy that never allocates;
+// rollback, undo and searches can keep as many as they need in plain arrays
+struct GameSnapshot
+{
+    Grid grid; // Bitboard, color plane, column tops and hash, so a restore recomputes nothing
+    BlockBag bag; // The block generator, mid-bag
+    PieceQueue queue; // The upcoming blocks
+    Block currentBlock; // The block in play, with its rotation and offsets
+    Random garbageRandom; // The garbage holes' generator
+    uint64_t garbageSeed; // Where a reset restarts the holes
+    int score;
+    int linesCleared;
+    int blocksPlaced;
+    int inputCount;
+    int garbageSent; // Garbage rows sent and not taken by the match yet
+    int pendingGarbage; // Garbage rows received and not risen yet
+    bool gameOver;
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "snapshots are saved and restored as plain copies");
+
+// The Tetris rules: grid, blocks, bag, gravity and scoring
+// Has no rendering, audio or window dependencies, so it runs headless
 class Game
 {
 public:
-    Game(); // Constructor: Initializes the game state and resources
-    ~Game(); // Destructor: Cleans up resources when the game ends
-    void Draw(); // Draws the game grid, current block, and next block
-    void HandleInput(); // Handles player input for controlling the game
+    Game(); // Constructor: Initializes the game state
+    void ApplyInput(GameInput input); // Applies one input to the current block without allocating
     void MoveBlockDown(); // Moves the current block down
     void Dropblock(); // Drop fast the block
-    void Reset(); // Resets the game state
+    void PlaceBlock(const Block& block); // Locks a placement of the current block (e.g. from the move generator) without replaying its inputs
+    void Reset(); // Resets the game state; the bag continues, the garbage holes restart from the last seed
+    void Reset(uint64_t seed); // Resets the game state and restarts the block sequence for the seed
+    void LoadGrid(const Grid& board); // Replaces the board (e.g. a position loaded from a file), keeping the blocks
+    int TakeEvents(); // Returns and clears the GameEvent flags raised since the last call
+
+    // Rollback and undo: a snapshot holds the whole game, and restoring it continues exactly as the game would have
+    void Save(GameSnapshot& snapshot) const; // Copies the game's state into a snapshot
+    void Restore(const GameSnapshot& snapshot); // Returns the game to a saved state; events not taken yet are dropped
+
+    // Versus play: line clears attack the opponents with garbage rows
+    // Rows sent by clears queue up here until the match takes them for an opponent
+    int TakeGarbage(); // Returns and clears the garbage rows sent since the last call
+    void ReceiveGarbage(int rows); // Queues garbage rows; they rise under the stack when a block locks without a clear
+    int GetPendingGarbage() const { return pendingGarbage; } // Garbage rows queued and not risen yet
 
+    // Read-only access for rendering and analysis
+    const Grid& GetGrid() const { return grid; }
+    const Block& GetCurrentBlock() const { return currentBlock; }
+    Block GetNextBlock() const { return Block(queue.Peek(0)); }
+    int GetUpcomingBlock(int index) const { return queue.Peek(index); } // ID of a queued block; 0 is the next one
+    int GetQueueSize() const { return queue.GetSize(); } // Number of upcoming blocks that can be peeked
+    int GetDropDistance() const; // Rows the current block can fall before it lands (where a drop would lock it)
+
+    // Zobrist hash of the position a search sees: board, current block and queue
+    // The board's part is kept up to date as blocks lock and rows clear; the blocks' part is a few XORs
+    uint64_t GetHash() const;
 
     bool gameOver; // Tracks whether the game is over
     int score; // Stores the player's score
-    Music music; // Background music for the game
+    int linesCleared; // Number of rows cleared this game
+    int blocksPlaced; // Number of blocks locked into the grid this game
+    int inputCount; // Number of inputs applied this game (the game's length)
 
 private:
     void SwapNextBlockWithCurrent(); // Handles swapping the next block with the current block
     void MoveBlockLeft(); // Moves the current block to the left
     void MoveBlockRight(); // Moves the current block to the right
-    Block GetRandomBlock(); // Selects and returns a random block
-    std::vector<Block> GetAllBlocks(); // Returns a vector of all possible Tetris blocks
-    bool IsBlockOutside(); // Checks if the current block is outside the grid
+    Block GetRandomBlock(); // Takes the next block from the queue
     void RotateBlock(); // Rotates the current block
     void LockBlock(); // Locks the current block into the grid and spawns the next block
-    bool BlockFits(); // Checks if the current block fits in the grid
+    bool BlockFits(); // Checks in one pass that the current block is inside the grid and on empty cells
     void UpdateScore(int linesCleared, int moveDownPoints); // Updates the player's score
+    void ExchangeGarbage(int rowsCleared); // Sends garbage for a clear, after cancelling what was queued against it
 
     Grid grid; // Represents the Tetris game board
-    std::vector<Block> blocks; // Stores all available Tetris blocks
+    BlockBag bag; // Seeded 7-bag generator dealing the blocks
+    PieceQueue queue; // Upcoming blocks, refilled from the bag
     Block currentBlock; // The block currently being controlled by the player
-    Block nextBlock; // The next block to be dropped
-    Sound rotateSound; // Sound effect for rotating the block
-    Sound clearSound; // Sound effect for clearing rows
+    int events; // GameEvent flags raised since the last TakeEvents call
+    int garbageSent; // Garbage rows sent since the last TakeGarbage call
+    int pendingGarbage; // Garbage rows received and not risen yet
+    Random garbageRandom; // Picks the hole column of each garbage attack, from the game's seed
+    uint64_t garbageSeed; // Seed of garbageRandom, restarted by every reset
 };
+
+// Garbage rows a clear of 0 to 4 rows sends to an opponent
+const int garbageForClear[5] = { 0, 0, 1, 2, 4 };
+
+// Calculates the gravity interval (seconds per row) based on the score
+double CalculationInterval(int score);
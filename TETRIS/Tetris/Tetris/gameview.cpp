@@ -0,0 +1,539 @@
+#include "gameview.h" // Includes the header file for the GameView class
+#include "colors.h"   // Includes the colors for rendering the grid cells and blocks
+#include "perfoverlay.h" // Includes the draw call counter of the frame timings overlay
+#include <cstring>    // Includes memcmp and memcpy for the rows of the grid layer
+
+// Size of each cell on the screen (e.g., 30x30 pixels)
+static const int cellSize = 30;
+
+// Constructor: Plays the sound effects through audio
+GameView::GameView(AudioEngine& audio)
+    : audio(audio)
+{
+}
+
+// Translates the key pressed this frame into a game input; returns true and the input if one was applied
+bool GameView::HandleInput(Game& game, GameInput& input)
+{
+    int keyPressed = GetKeyPressed(); // Get the key pressed by the player
+    if (game.gameOver && keyPressed != 0) // If the game is over and any key is pressed
+    {
+        game.gameOver = false; // Reset the game state
+    }
+    switch (keyPressed) // Handle specific key presses
+    {
+    case KEY_A:
+    case KEY_LEFT:
+        input = INPUT_LEFT; // Move the current block left
+        break;
+    case KEY_D:
+    case KEY_RIGHT:
+        input = INPUT_RIGHT; // Move the current block right
+        break;
+    case KEY_S:
+    case KEY_DOWN:
+        input = INPUT_DOWN; // Move the current block down
+        break;
+    case KEY_W:
+    case KEY_UP:
+        input = INPUT_ROTATE; // Rotate the current block
+        break;
+    case KEY_SPACE:
+        input = INPUT_DROP; // Drops the blocks automatically
+        break;
+    default:
+        return false; // Not a game key
+    }
+    game.ApplyInput(input);
+    return true;
+}
+
+// Plays the sounds for the game's events; the music streams on its own thread
+void GameView::Update(Game& game)
+{
+    int events = game.TakeEvents(); // Events raised by the rules since the last frame
+    if (events & EVENT_ROTATED) // The block was rotated
+    {
+        audio.PlayEffect(ASSET_ROTATE_SOUND); // Play the rotation sound effect (silent until loaded)
+    }
+    if (events & EVENT_ROWS_CLEARED) // Rows were cleared
+    {
+        audio.PlayEffect(ASSET_CLEAR_SOUND); // Play the row clear sound effect
+    }
+}
+
+// Draws a rectangle with a stroke
+void DrawRectangleWithStroke(Rectangle rect, Color fillColor, Color strokeColor, float strokeThickness)
+{
+    PERF_COUNT_DRAWS(2);
+    // Draw the stroke (outer rectangle)
+    DrawRectangle(
+        rect.x - strokeThickness, // Adjust position for stroke
+        rect.y - strokeThickness,
+        rect.width + 2 * strokeThickness, // Increase size for stroke
+        rect.height + 2 * strokeThickness,
+        strokeColor // Stroke color
+    );
+
+    // Draw the inner rectangle (fill)
+    DrawRectangle(
+        rect.x, // Original position
+        rect.y,
+        rect.width, // Original size
+        rect.height,
+        fillColor // Fill color
+    );
+}
+
+// Draws the game grid, current block, and next block
+void GameView::Draw(const Game& game, float fallProgress)
+{
+    PERF_SCOPE(PERF_DRAW_GRID);
+    gridLayer.Draw(game.GetGrid(), 11, 11); // Draw the game grid from its cached texture
+
+    // Draw the ghost block where a drop would lock the current block, under it
+    const Block& currentBlock = game.GetCurrentBlock();
+    Position blockCells[4];
+    currentBlock.GetCellPositions(blockCells);
+    int dropDistance = game.GetDropDistance(); // Read from the grid's column tops, so it costs no collision steps
+    if (dropDistance > 0)
+    {
+        Color ghostColor = GetCellColor(currentBlock.id);
+        Color ghostFill = ghostColor;
+        ghostFill.a = 60; // Faint fill, so the ghost never hides the locked cells around it
+        for (Position cell : blockCells)
+        {
+            int x = cell.column * cellSize + 11;
+            int y = (cell.row + dropDistance) * cellSize + 11;
+            DrawRectangle(x, y, cellSize - 1, cellSize - 1, ghostFill);
+            DrawRectangleLines(x, y, cellSize - 1, cellSize - 1, ghostColor);
+            PERF_COUNT_DRAWS(2);
+        }
+    }
+
+    // Draw the current block
+    int fallPixels = 0; // Offset of a block drawn between rows; a block resting on the stack stays on its row
+    if (fallProgress > 0.0f && dropDistance > 0)
+    {
+        fallPixels = static_cast<int>(fallProgress * cellSize);
+    }
+    for (Position cell : blockCells)
+    {
+        int x = cell.column * cellSize + 11;
+        int y = cell.row * cellSize + 11 + fallPixels;
+
+        DrawRectangleWithStroke(
+            { static_cast<float>(x), static_cast<float>(y), static_cast<float>(cellSize - 1), static_cast<float>(cellSize - 1) },
+            GetCellColor(currentBlock.id),
+            WHITE,
+            2.0f
+        );
+    }
+
+    // Draw the next block in the "next rectangle" position
+    Block nextBlock = game.GetNextBlock();
+    if (nextBlock.id != 0) // Ensure there is a next block to draw
+    {
+        // Define the "next rectangle" dimensions
+        int nextRectX = 270; // X-coordinate of the rectangle
+        int nextRectY = 220; // Y-coordinate of the rectangle
+        int nextRectWidth = 120; // Width of the rectangle
+        int nextRectHeight = 120; // Height of the rectangle
+
+        // Use the centering version of DrawBlock
+        DrawBlock(nextBlock, nextRectX, nextRectY, nextRectWidth, nextRectHeight);
+    }
+
+    // Draw the blocks queued after the next one, smaller, in the "later" panel
+    for (int i = 0; i < previewCount && i + 1 < game.GetQueueSize(); i++)
+    {
+        DrawBlockPreview(game.GetUpcomingBlock(i + 1), 320, 345 + i * 60, 170, 60, 15);
+    }
+}
+
+// Draws the grid on the screen, rendering each cell with its corresponding color
+void DrawGrid(const Grid& grid)
+{
+    int numRows = grid.GetNumRows(); // Number of rows in the grid
+    int numCols = grid.GetNumCols(); // Number of columns in the grid
+
+    // Draw a solid black background for the grid area
+    DrawRectangle(
+        11,                // X-coordinate of the grid area
+        11,                // Y-coordinate of the grid area
+        numCols * cellSize, // Width of the grid area
+        numRows * cellSize, // Height of the grid area
+         BLACK   // Background color
+    );
+
+    // Draw the grid lines
+    for (int row = 0; row <= numRows; row++) // Horizontal lines
+    {
+        DrawLine(
+            11, // Start X
+            11 + row * cellSize, // Start Y
+            11 + numCols * cellSize, // End X
+            11 + row * cellSize, // End Y
+           GRAY // Line color
+        );
+    }
+
+    for (int col = 0; col <= numCols; col++) // Vertical lines
+    {
+        DrawLine(
+            11 + col * cellSize, // Start X
+            11, // Start Y
+            11 + col * cellSize, // End X
+            11 + numRows * cellSize, // End Y
+            GRAY // Line color
+        );
+    }
+
+    // Draw the grid cells with their respective colors
+    for (int row = 0; row < numRows; row++) // Iterate through each row
+    {
+        for (int column = 0; column < numCols; column++) // Iterate through each column
+        {
+            int cellValue = grid.GetCell(row, column); // Get the value of the cell
+
+            if (cellValue != 0) // Only draw non-empty cells
+            {
+                // Draw the block (inner rectangle)
+                DrawRectangle(
+                    column * cellSize + 11, // X-coordinate of the block
+                    row * cellSize + 11,    // Y-coordinate of the block
+                    cellSize - 1,           // Width of the block (slightly smaller for spacing)
+                    cellSize - 1,           // Height of the block (slightly smaller for spacing)
+                    GetCellColor(cellValue) // Color of the block based on the cell value
+                );
+            }
+        }
+    }
+}
+
+// Constructor: Starts without a texture; it is created by the first Draw, once the window is open
+GridLayer::GridLayer()
+{
+    texture = RenderTexture2D{};
+    hasTexture = false;
+    patchedRows = 0;
+}
+
+// Destructor: Releases the texture while the window is still open
+GridLayer::~GridLayer()
+{
+    if (hasTexture && IsWindowReady()) // Closing the window already released it with the rest of the GPU state
+    {
+        UnloadRenderTexture(texture);
+    }
+}
+
+// Draws one row's background, lines and cells into a render texture, with the grid's top-left corner at left and
+// the row's band at top; called between BeginTextureMode and EndTextureMode
+// A row owns the band from its top line down to the next row's top line; its cells cover the lines' top-left pixels,
+// as they do on the screen, so redrawing a band never touches its neighbours
+static void DrawGridRow(const Grid& grid, int row, int left, int top, int size)
+{
+    int numCols = grid.GetNumCols();
+    PERF_COUNT_DRAWS(numCols + 3); // The background and the lines; each locked cell is counted below
+    DrawRectangle(left, top, numCols * size + 1, size, BLACK); // Background of the band
+    DrawRectangle(left, top, numCols * size + 1, 1, GRAY); // The row's top line, one pixel high
+    for (int col = 0; col <= numCols; col++) // The vertical lines through the band, one pixel wide
+    {
+        DrawRectangle(left + col * size, top, 1, size, GRAY);
+    }
+    for (int column = 0; column < numCols; column++) // The row's locked cells
+    {
+        int cellValue = grid.GetCell(row, column);
+        if (cellValue != 0)
+        {
+            DrawRectangle(left + column * size, top, size - 1, size - 1, GetCellColor(cellValue));
+            PERF_COUNT_DRAWS(1);
+        }
+    }
+}
+
+// Redraws one row's background, lines and cells; called between BeginTextureMode and EndTextureMode
+void GridLayer::DrawRow(const Grid& grid, int row)
+{
+    DrawGridRow(grid, row, 0, row * cellSize, cellSize);
+}
+
+// Brings the texture up to date with the grid, then draws it with its top-left corner at (x, y)
+void GridLayer::Draw(const Grid& grid, int x, int y)
+{
+    int numRows = grid.GetNumRows();
+    int numCols = grid.GetNumCols();
+    int width = numCols * cellSize + 1; // One more pixel for the right and bottom lines
+    int height = numRows * cellSize + 1;
+    patchedRows = 0;
+    bool redrawAll = !hasTexture;
+    if (!hasTexture)
+    {
+        texture = LoadRenderTexture(width, height);
+        hasTexture = true;
+    }
+
+    for (int row = 0; row < numRows; row++)
+    {
+        if (!redrawAll && memcmp(drawnCells[row], grid.cellColors[row], sizeof(drawnCells[row])) == 0)
+        {
+            continue; // The texture already shows this row
+        }
+        if (patchedRows == 0) // First changed row: start drawing into the texture
+        {
+            BeginTextureMode(texture);
+            if (redrawAll)
+            {
+                ClearBackground(BLACK);
+                DrawRectangle(0, numRows * cellSize, width, 1, GRAY); // The bottom line, below every row's band
+            }
+        }
+        DrawRow(grid, row);
+        memcpy(drawnCells[row], grid.cellColors[row], sizeof(drawnCells[row]));
+        patchedRows++;
+    }
+    if (patchedRows > 0)
+    {
+        EndTextureMode();
+    }
+
+    // Render textures are stored bottom-up, so the source rectangle flips them back
+    PERF_COUNT_DRAWS(1);
+    DrawTextureRec(texture.texture, { 0, 0, static_cast<float>(width), static_cast<float>(-height) },
+        { static_cast<float>(x), static_cast<float>(y) }, WHITE);
+}
+
+// Draws a block on the screen at the specified offset
+void DrawBlock(const Block& block, int offsetX, int offsetY)
+{
+    Position tiles[4]; // The current positions of the block's cells
+    block.GetCellPositions(tiles);
+    PERF_COUNT_DRAWS(4);
+    for (Position item : tiles) // Iterates through each cell in the block
+    {
+        // Draws a rectangle for each cell at its calculated position
+        DrawRectangle(
+            item.column * cellSize + offsetX, // X-coordinate of the rectangle
+            item.row * cellSize + offsetY,   // Y-coordinate of the rectangle
+            cellSize - 1,                    // Width of the rectangle (slightly smaller for spacing)
+            cellSize - 1,                    // Height of the rectangle (slightly smaller for spacing)
+            GetCellColor(block.id)           // Color of the rectangle based on the block's ID
+        );
+    }
+}
+
+// Draws a block centered within a rectangle
+void DrawBlock(const Block& block, int offsetX, int offsetY, int rectWidth, int rectHeight)
+{
+    // Calculate the total width and height of the block based on its cells
+    int blockWidth = cellSize * 4;  // Assuming a maximum of 4 cells wide
+    int blockHeight = cellSize * 4; // Assuming a maximum of 4 cells tall
+
+    // Calculate the centering offsets within the rectangle
+    int centerX = offsetX + (rectWidth - blockWidth) / 2;
+    int centerY = offsetY + (rectHeight - blockHeight) / 2;
+
+    // Draws the block at the centered offset
+    DrawBlock(block, centerX, centerY);
+}
+
+// Draws a block in its spawn orientation, centered within a rectangle with the given cell size
+void DrawBlockPreview(int id, int offsetX, int offsetY, int rectWidth, int rectHeight, int previewCellSize)
+{
+    const PieceRotation& rotation = pieceShapes[id].rotations[0]; // Spawn orientation
+    int blockWidth = (rotation.maxColumn - rotation.minColumn + 1) * previewCellSize; // Size of the block's bounding box
+    int blockHeight = (rotation.maxRow - rotation.minRow + 1) * previewCellSize;
+    int centerX = offsetX + (rectWidth - blockWidth) / 2; // Center the bounding box
+    int centerY = offsetY + (rectHeight - blockHeight) / 2;
+    PERF_COUNT_DRAWS(4);
+    for (Position item : rotation.cells) // Iterates through each cell in the block
+    {
+        DrawRectangle(
+            centerX + (item.column - rotation.minColumn) * previewCellSize, // X-coordinate of the rectangle
+            centerY + (item.row - rotation.minRow) * previewCellSize,       // Y-coordinate of the rectangle
+            previewCellSize - 1,                                          // Width of the rectangle (slightly smaller for spacing)
+            previewCellSize - 1,                                          // Height of the rectangle (slightly smaller for spacing)
+            GetCellColor(id)                                              // Color of the rectangle based on the block's ID
+        );
+    }
+}
+
+// The players' keys, each row in GameInput order: left, right, down, rotate, drop
+const VersusKeys versusKeys[maxVersusPlayers] = {
+    { { KEY_A, KEY_D, KEY_S, KEY_W, KEY_SPACE }, "A D S W + SPACE" },
+    { { KEY_LEFT, KEY_RIGHT, KEY_DOWN, KEY_UP, KEY_RIGHT_CONTROL }, "ARROWS + RIGHT CTRL" },
+    { { KEY_J, KEY_L, KEY_K, KEY_I, KEY_U }, "J L K I + U" },
+    { { KEY_KP_4, KEY_KP_6, KEY_KP_5, KEY_KP_8, KEY_KP_0 }, "KEYPAD 4 6 5 8 + 0" },
+};
+
+// Applies the inputs whose keys were pressed this frame to one player's game
+int HandleVersusInput(Game& game, const VersusKeys& keys)
+{
+    int applied = 0;
+    for (int input = INPUT_LEFT; input <= INPUT_DROP; input++)
+    {
+        if (IsKeyPressed(keys.keys[input]))
+        {
+            game.ApplyInput(static_cast<GameInput>(input));
+            applied++;
+        }
+    }
+    return applied;
+}
+
+// Size of each cell of the versus boards, smaller than the single board's so four fit side by side
+static const int versusCellSize = 24;
+static const int versusBoardTop = 60; // Screen row of the boards' top edge
+static const int versusSlotWidth = Grid::numCols * versusCellSize + 1; // A board in the shared texture, with its right line
+static const int versusSlotHeight = Grid::numRows * versusCellSize + 1; // And its bottom line
+
+// Screen column of a player's board's left edge
+static int VersusBoardLeft(int player)
+{
+    return player * versusPanelWidth + 20;
+}
+
+// Each player's name color
+static const Color versusPlayerColors[maxVersusPlayers] = { SKYBLUE, ORANGE, GREEN, PURPLE };
+
+// Constructor: Starts without a texture; it is created by the first Draw, once the window is open
+VersusView::VersusView()
+{
+    atlas = RenderTexture2D{};
+    hasTexture = false;
+    patchedRows = 0;
+}
+
+// Destructor: Releases the texture while the window is still open
+VersusView::~VersusView()
+{
+    if (hasTexture && IsWindowReady()) // Closing the window already released it with the rest of the GPU state
+    {
+        UnloadRenderTexture(atlas);
+    }
+}
+
+// Draws every player's board, blocks, next block, pending garbage and name, and who won once it is over
+void VersusView::Draw(const Match& match, Font font)
+{
+    PERF_SCOPE(PERF_DRAW_GRID);
+    int numPlayers = match.GetNumPlayers();
+
+    // Bring the shared texture up to date: the rows that changed on any board, in one texture pass
+    patchedRows = 0;
+    bool redrawAll = !hasTexture;
+    if (!hasTexture)
+    {
+        atlas = LoadRenderTexture(versusSlotWidth * maxVersusPlayers, versusSlotHeight);
+        hasTexture = true;
+    }
+    for (int player = 0; player < numPlayers; player++)
+    {
+        const Grid& grid = match.GetPlayer(player).GetGrid();
+        for (int row = 0; row < grid.GetNumRows(); row++)
+        {
+            if (!redrawAll && memcmp(drawnCells[player][row], grid.cellColors[row], sizeof(drawnCells[player][row])) == 0)
+            {
+                continue; // The slot already shows this row
+            }
+            if (patchedRows == 0) // First changed row: start drawing into the texture
+            {
+                BeginTextureMode(atlas);
+                if (redrawAll)
+                {
+                    ClearBackground(BLACK);
+                    DrawRectangle(0, versusSlotHeight - 1, versusSlotWidth * maxVersusPlayers, 1, GRAY); // Every slot's bottom line
+                }
+            }
+            DrawGridRow(grid, row, player * versusSlotWidth, row * versusCellSize, versusCellSize);
+            memcpy(drawnCells[player][row], grid.cellColors[row], sizeof(drawnCells[player][row]));
+            patchedRows++;
+        }
+    }
+    if (patchedRows > 0)
+    {
+        EndTextureMode();
+    }
+
+    // First pass: every board from its slot; all quads of one texture, so raylib draws them together
+    PERF_COUNT_DRAWS(numPlayers);
+    for (int player = 0; player < numPlayers; player++)
+    {
+        // Render textures are stored bottom-up, so the source rectangle flips them back
+        DrawTextureRec(atlas.texture,
+            { static_cast<float>(player * versusSlotWidth), 0, static_cast<float>(versusSlotWidth), static_cast<float>(-versusSlotHeight) },
+            { static_cast<float>(VersusBoardLeft(player)), static_cast<float>(versusBoardTop) }, WHITE);
+    }
+
+    // Second pass: the blocks, next blocks and garbage meters, all plain rectangles
+    for (int player = 0; player < numPlayers; player++)
+    {
+        const Game& game = match.GetPlayer(player);
+        int left = VersusBoardLeft(player);
+        if (game.gameOver) // Dim the board of a player who is out
+        {
+            DrawRectangle(left, versusBoardTop, versusSlotWidth, versusSlotHeight, Color{ 0, 0, 0, 150 });
+            PERF_COUNT_DRAWS(1);
+            continue;
+        }
+
+        // The ghost block, then the current block over it
+        const Block& currentBlock = game.GetCurrentBlock();
+        Position blockCells[4];
+        currentBlock.GetCellPositions(blockCells);
+        int dropDistance = game.GetDropDistance();
+        Color blockColor = GetCellColor(currentBlock.id);
+        Color ghostFill = blockColor;
+        ghostFill.a = 60; // Faint fill, so the ghost never hides the locked cells around it
+        for (Position cell : blockCells)
+        {
+            Rectangle rect = { static_cast<float>(left + cell.column * versusCellSize),
+                static_cast<float>(versusBoardTop + (cell.row + dropDistance) * versusCellSize),
+                static_cast<float>(versusCellSize - 1), static_cast<float>(versusCellSize - 1) };
+            if (dropDistance > 0)
+            {
+                DrawRectangleRec(rect, ghostFill);
+                DrawRectangleLinesEx(rect, 1.0f, blockColor); // Four rectangles, so it stays in the pass's batch
+                PERF_COUNT_DRAWS(2);
+            }
+            rect.y -= dropDistance * versusCellSize;
+            DrawRectangleWithStroke(rect, blockColor, WHITE, 2.0f);
+        }
+
+        // The next block, and the garbage waiting to rise as a red bar beside the board
+        int sideLeft = left + versusSlotWidth + 4;
+        DrawBlockPreview(game.GetUpcomingBlock(0), sideLeft + 10, versusBoardTop + 24, 44, 40, 10);
+        int pending = game.GetPendingGarbage();
+        if (pending > 0)
+        {
+            int meterHeight = pending * versusCellSize < versusSlotHeight ? pending * versusCellSize : versusSlotHeight;
+            DrawRectangle(sideLeft, versusBoardTop + versusSlotHeight - meterHeight, 6, meterHeight, RED);
+            PERF_COUNT_DRAWS(1);
+        }
+    }
+
+    // Third pass: the text, all in the font's texture
+    int winner = match.GetWinner();
+    for (int player = 0; player < numPlayers; player++)
+    {
+        const Game& game = match.GetPlayer(player);
+        int left = VersusBoardLeft(player);
+        PERF_COUNT_DRAWS(4);
+        DrawTextEx(font, TextFormat("P%d", player + 1), { static_cast<float>(left), 18 }, 32, 2, versusPlayerColors[player]);
+        DrawTextEx(font, TextFormat("%d", game.score), { static_cast<float>(left + 60), 22 }, 26, 2, WHITE);
+        DrawTextEx(font, "NEXT", { static_cast<float>(left + versusSlotWidth + 12), static_cast<float>(versusBoardTop) }, 16, 1, WHITE);
+        DrawTextEx(font, versusKeys[player].names, { static_cast<float>(left), static_cast<float>(versusBoardTop + versusSlotHeight + 8) },
+            18, 1, LIGHTGRAY);
+        if (game.gameOver)
+        {
+            DrawTextEx(font, "KO", { static_cast<float>(left + 90), static_cast<float>(versusBoardTop + 200) }, 60, 2, RED);
+            PERF_COUNT_DRAWS(1);
+        }
+        else if (player == winner)
+        {
+            DrawTextEx(font, "WINNER", { static_cast<float>(left + 40), static_cast<float>(versusBoardTop + 200) }, 50, 2, YELLOW);
+            PERF_COUNT_DRAWS(1);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <raylib.h> // Includes the raylib library for rendering, input and audio
+#include "game.h"   // Includes the headless Game rules this view presents
+#include "audio.h"  // Includes the audio engine playing the sound effects
+#include "versus.h" // Includes the versus match whose boards the split screen draws
+
+// Off-screen copy of the grid's lines and locked cells, so a frame draws the whole grid as one textured quad
+// The locked cells change only when a block locks, so rows are redrawn into the texture only when their cells differ
+// from the ones it holds: a lock patches the rows it touched, a line clear the rows that moved
+class GridLayer
+{
+public:
+    GridLayer(); // Constructor: Starts without a texture; it is created by the first Draw, once the window is open
+    ~GridLayer(); // Destructor: Releases the texture while the window is still open
+    GridLayer(const GridLayer&) = delete;
+    GridLayer& operator=(const GridLayer&) = delete;
+
+    // Brings the texture up to date with the grid, then draws it with its top-left corner at (x, y)
+    void Draw(const Grid& grid, int x, int y);
+
+    // Rows redrawn into the texture by the last Draw (0 when the grid did not change)
+    int GetPatchedRows() const { return patchedRows; }
+
+private:
+    // Redraws one row's background, lines and cells; called between BeginTextureMode and EndTextureMode
+    void DrawRow(const Grid& grid, int row);
+
+    RenderTexture2D texture; // The grid as last drawn
+    bool hasTexture; // The texture has been created and fully drawn once
+    unsigned char drawnCells[Grid::numRows][Grid::numCols]; // Color plane the texture shows
+    int patchedRows; // Rows redrawn by the last Draw
+};
+
+// Thin presentation layer over a Game: keyboard input, drawing and audio
+// All raylib calls for the board live here so the rules stay headless
+class GameView
+{
+public:
+    explicit GameView(AudioEngine& audio); // Constructor: Plays the sound effects through audio
+
+    // Translates the key pressed this frame into a game input; returns true and the input if one was applied
+    bool HandleInput(Game& game, GameInput& input);
+    void Update(Game& game); // Plays the sounds for the game's events
+    // Draws the game grid, current block, and next block
+    // fallProgress in [0, 1] draws the current block that far towards the next row, when it fits there
+    void Draw(const Game& game, float fallProgress = 0.0f);
+
+private:
+    AudioEngine& audio; // Plays the sound effects
+    GridLayer gridLayer; // Cached drawing of the locked cells
+};
+
+// Draws the grid on the screen, rendering each cell with its corresponding color
+// Issues one call per line and cell every time; the game draws through a GridLayer instead
+void DrawGrid(const Grid& grid);
+
+// Draws a block on the screen at the specified offset
+void DrawBlock(const Block& block, int offsetX, int offsetY);
+
+// Draws a block centered within a rectangle
+void DrawBlock(const Block& block, int offsetX, int offsetY, int rectWidth, int rectHeight);
+
+// Draws a block in its spawn orientation, centered within a rectangle with the given cell size
+void DrawBlockPreview(int id, int offsetX, int offsetY, int rectWidth, int rectHeight, int previewCellSize);
+
+// Number of queued blocks shown after the next block
+const int previewCount = 3;
+
+// One versus player's keys on the shared keyboard
+struct VersusKeys
+{
+    int keys[5]; // Key of each GameInput, in the enum's order (left, right, down, rotate, drop)
+    const char* names; // The keys as shown under the board
+};
+
+// The players' keys: WASD, the arrows, IJKL and the numeric keypad, each with a drop key beside it
+extern const VersusKeys versusKeys[maxVersusPlayers];
+
+// Applies the inputs whose keys were pressed this frame to one player's game; returns the number applied
+// Reads each key with IsKeyPressed, so players pressing at the same time all get their inputs
+int HandleVersusInput(Game& game, const VersusKeys& keys);
+
+const int versusPanelWidth = 320; // Screen width each player's board, next block and garbage meter take
+const int versusScreenHeight = 620; // Screen height of the split screen
+
+// Draws the boards of a versus match side by side
+// Every board's locked cells live in one shared texture, one slot per player, patched row by row like a GridLayer;
+// the frame then draws all boards in three passes (the texture slots, the blocks and meters, the text), so
+// raylib batches each pass into one draw call whatever the number of players, where drawing each board on
+// its own would switch textures, and flush the batch, several times per board
+class VersusView
+{
+public:
+    VersusView(); // Constructor: Starts without a texture; it is created by the first Draw, once the window is open
+    ~VersusView(); // Destructor: Releases the texture while the window is still open
+    VersusView(const VersusView&) = delete;
+    VersusView& operator=(const VersusView&) = delete;
+
+    // Draws every player's board, blocks, next block, pending garbage and name, and who won once it is over
+    void Draw(const Match& match, Font font);
+
+    // Rows redrawn into the shared texture by the last Draw, over every board
+    int GetPatchedRows() const { return patchedRows; }
+
+private:
+    RenderTexture2D atlas; // Every board's grid, one slot per player side by side
+    bool hasTexture; // The texture has been created and fully drawn once
+    unsigned char drawnCells[maxVersusPlayers][Grid::numRows][Grid::numCols]; // Color plane each slot shows
+    int patchedRows; // Rows redrawn by the last Draw
+};
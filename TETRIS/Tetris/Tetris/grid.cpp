@@ -1,99 +1,45 @@
 #include "grid.h" // Includes the header file for the Grid class
 #include <iostream> // Includes the iostream library for printing the grid to the console
-#include "colors.h" // Includes the colors for rendering the grid cells
+#include <cstring> // Includes memcpy/memset for whole-row copies of the color plane
+#include "trace.h" // Includes the span of the line clear
 
 // Constructor: Initializes the grid with default values
-Grid::Grid()
+template <int Rows, int Cols, typename Mask>
+BasicGrid<Rows, Cols, Mask>::BasicGrid()
 {
-    numRows = 20; // Number of rows in the grid
-    numCols = 10; // Number of columns in the grid
-    cellSize = 30; // Size of each cell in the grid (e.g., 30x30 pixels)
     Initialize(); // Initializes the grid with empty cells
-    colors = GetCellColors(); // Retrieves the predefined colors for rendering cells
 }
 
 // Initializes the grid by setting all cells to 0 (empty)
-void Grid::Initialize()
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::Initialize()
 {
     for (int row = 0; row < numRows; row++) // Iterate through each row
     {
-        for (int column = 0; column < numCols; column++) // Iterate through each column
-        {
-            grid[row][column] = 0; // Set the cell to 0 (empty)
-        }
+        rows[row] = emptyRow; // Only the wall bits remain
     }
+    memset(cellColors, 0, sizeof(cellColors)); // Empty every color
+    hash = 0; // Empty rows have no key
+    memset(columnTops, numRows, sizeof(columnTops)); // Every column is empty
 }
 
 // Prints the grid to the console (for debugging purposes)
-void Grid::Print()
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::Print()
 {
     for (int row = 0; row < numRows; row++) // Iterate through each row
     {
         for (int column = 0; column < numCols; column++) // Iterate through each column
         {
-            std::cout << grid[row][column] << " "; // Print the cell value
+            std::cout << (int)cellColors[row][column] << " "; // Print the cell value
         }
         std::cout << std::endl; // Move to the next line after each row
     }
 }
 
-void Grid::Draw()
-{
-    // Draw a solid black background for the grid area
-    DrawRectangle(
-        11,                // X-coordinate of the grid area
-        11,                // Y-coordinate of the grid area
-        numCols * cellSize, // Width of the grid area
-        numRows * cellSize, // Height of the grid area
-         BLACK   // Background color
-    );
-
-    // Draw the grid lines
-    for (int row = 0; row <= numRows; row++) // Horizontal lines
-    {
-        DrawLine(
-            11, // Start X
-            11 + row * cellSize, // Start Y
-            11 + numCols * cellSize, // End X
-            11 + row * cellSize, // End Y
-           GRAY // Line color
-        );
-    }
-
-    for (int col = 0; col <= numCols; col++) // Vertical lines
-    {
-        DrawLine(
-            11 + col * cellSize, // Start X
-            11, // Start Y
-            11 + col * cellSize, // End X
-            11 + numRows * cellSize, // End Y
-            GRAY // Line color
-        );
-    }
-
-    // Draw the grid cells with their respective colors
-    for (int row = 0; row < numRows; row++) // Iterate through each row
-    {
-        for (int column = 0; column < numCols; column++) // Iterate through each column
-        {
-            int cellValue = grid[row][column]; // Get the value of the cell
-
-            if (cellValue != 0) // Only draw non-empty cells
-            {
-                // Draw the block (inner rectangle)
-                DrawRectangle(
-                    column * cellSize + 11, // X-coordinate of the block
-                    row * cellSize + 11,    // Y-coordinate of the block
-                    cellSize - 1,           // Width of the block (slightly smaller for spacing)
-                    cellSize - 1,           // Height of the block (slightly smaller for spacing)
-                    colors[cellValue]       // Color of the block based on the cell value
-                );
-            }
-        }
-    }
-}
 // Checks if a cell is outside the grid boundaries
-bool Grid::IsCellOutside(int row, int column)
+template <int Rows, int Cols, typename Mask>
+bool BasicGrid<Rows, Cols, Mask>::IsCellOutside(int row, int column)
 {
     if (row >= 0 && row < numRows && column >= 0 && column < numCols) // Check if the cell is within bounds
     {
@@ -103,24 +49,87 @@ bool Grid::IsCellOutside(int row, int column)
 }
 
 // Checks if a cell is empty (value is 0)
-bool Grid::IsCellEmpty(int row, int column)
+template <int Rows, int Cols, typename Mask>
+bool BasicGrid<Rows, Cols, Mask>::IsCellEmpty(int row, int column)
 {
-    if (grid[row][column] == 0) // Check if the cell value is 0
+    if ((rows[row] & ((uint32_t)1 << (column + wallWidth))) == 0) // Check if the cell's bit is clear
     {
         return true; // The cell is empty
     }
     return false; // The cell is not empty
 }
 
+// Fills a cell with a block ID, updating both the bitboard and the color plane
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::SetCell(int row, int column, int value)
+{
+    Mask bit = (Mask)((uint32_t)1 << (column + wallWidth)); // The cell's bit
+    if (((rows[row] & bit) != 0) != (value != 0)) // The cell changes, so its key goes in or out of the hash
+    {
+        hash ^= zobristBoardKeys<Rows, Cols>.cells[row][column];
+    }
+    if (value != 0) // Filling the cell
+    {
+        rows[row] |= bit; // Set the cell's bit
+    }
+    else // Emptying the cell
+    {
+        rows[row] &= (Mask)~bit; // Clear the cell's bit
+    }
+    cellColors[row][column] = (unsigned char)value; // Store the block ID for rendering
+
+    if (value != 0 && row < columnTops[column]) // A new highest cell
+    {
+        columnTops[column] = (unsigned char)row;
+    }
+    else if (value == 0 && row == columnTops[column]) // The highest cell was emptied: find the next one down
+    {
+        int top = row + 1;
+        while (top < numRows && (rows[top] & bit) == 0)
+        {
+            top++;
+        }
+        columnTops[column] = (unsigned char)top;
+    }
+}
+
+// Checks if a piece fits with masks[0] on the given row and its local column 0 on the given column
+template <int Rows, int Cols, typename Mask>
+bool BasicGrid<Rows, Cols, Mask>::PieceFits(int row, int column, const RowMask masks[4]) const
+{
+    if (column < -wallWidth) // The piece would be shifted past the left wall bits
+    {
+        return false; // Far outside the grid
+    }
+    for (int i = 0; i < 4; i++) // Iterate through each row of the piece
+    {
+        if (masks[i] == 0) // Skip the piece's empty rows
+        {
+            continue;
+        }
+        uint64_t shifted = (uint64_t)masks[i] << (column + wallWidth); // Move the piece row into board columns
+        if (row + i < 0 || row + i >= numRows || shifted > (Mask)~0) // Above, below or past the right wall bits
+        {
+            return false; // The piece row is outside the grid
+        }
+        if (rows[row + i] & shifted) // Overlaps a filled cell or a wall
+        {
+            return false; // The piece doesn't fit
+        }
+    }
+    return true; // Every piece row is clear
+}
+
 // Clears full rows and moves rows above them down
-int Grid::ClearFullRows()
+template <int Rows, int Cols, typename Mask>
+int BasicGrid<Rows, Cols, Mask>::ClearFullRows()
 {
+    TRACE_SPAN("ClearFullRows");
     int completed = 0; // Tracks the number of rows cleared
     for (int row = numRows - 1; row >= 0; row--) // Iterate from the bottom row to the top
     {
         if (IsRowFull(row)) // Check if the row is full
         {
-            ClearRow(row); // Clear the full row
             completed++; // Increment the count of cleared rows
         }
         else if (completed > 0) // If rows have been cleared below
@@ -128,38 +137,116 @@ int Grid::ClearFullRows()
             MoveRowDown(row, completed); // Move the current row down by the number of cleared rows
         }
     }
+    for (int row = 0; row < completed; row++) // The top rows were moved down and are now empty
+    {
+        ClearRow(row); // Clear the vacated row
+    }
+    if (completed > 0) // The stack moved down
+    {
+        ComputeColumnTops();
+    }
     return completed; // Return the number of rows cleared
 }
 
-// Checks if a row is full (no empty cells)
-bool Grid::IsRowFull(int row)
+// Pushes the stack up by count rows and fills the bottom rows with garbage
+// The masks and colors of the surviving rows are contiguous, so each plane moves with one memmove;
+// every row changes its index, so the hash and the column tops are found again from the moved rows
+template <int Rows, int Cols, typename Mask>
+bool BasicGrid<Rows, Cols, Mask>::AddGarbageRows(int count, int holeColumn, int color)
 {
-    for (int column = 0; column < numCols; column++) // Iterate through each column in the row
+    if (count <= 0) // Nothing to add
+    {
+        return true;
+    }
+    count = count < numRows ? count : numRows; // A full board of garbage at most
+    bool fits = true;
+    for (int row = 0; row < count; row++) // The rows pushed out of the top must be empty
     {
-        if (grid[row][column] == 0) // Check if the cell is empty
+        if (rows[row] != emptyRow)
         {
-            return false; // The row is not full
+            fits = false;
         }
     }
-    return true; // The row is full
+    memmove(rows, rows + count, (numRows - count) * sizeof(rows[0])); // Shift the stack up
+    memmove(cellColors, cellColors + count, (numRows - count) * sizeof(cellColors[0]));
+
+    Mask garbageRow = (Mask)~(Mask)((uint32_t)1 << (holeColumn + wallWidth)); // Every cell but the hole
+    unsigned char garbageColors[Cols];
+    memset(garbageColors, color, sizeof(garbageColors));
+    garbageColors[holeColumn] = 0;
+    for (int row = numRows - count; row < numRows; row++) // The new bottom rows
+    {
+        rows[row] = garbageRow;
+        memcpy(cellColors[row], garbageColors, sizeof(garbageColors));
+    }
+    hash = ComputeHash();
+    ComputeColumnTops();
+    return fits;
+}
+
+// Checks if a row is full (no empty cells)
+template <int Rows, int Cols, typename Mask>
+bool BasicGrid<Rows, Cols, Mask>::IsRowFull(int row)
+{
+    return rows[row] == (Mask)~0; // Every playfield bit and every wall bit is set
 }
 
 // Clears a specific row by setting all its cells to 0 (empty)
-void Grid::ClearRow(int row)
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::ClearRow(int row)
+{
+    SetRow(row, emptyRow); // Only the wall bits remain
+    memset(cellColors[row], 0, sizeof(cellColors[row])); // Empty the row's colors
+}
+
+// Moves a row down by a specified number of rows
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::MoveRowDown(int row, int distance)
+{
+    SetRow(row + distance, rows[row]); // Move the whole row mask down
+    memcpy(cellColors[row + distance], cellColors[row], sizeof(cellColors[row])); // Move the row's colors down
+}
+
+// Replaces a row's mask, swapping its key in the hash
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::SetRow(int row, Mask cells)
+{
+    hash ^= ZobristRowKey<Rows, Cols>(row, rows[row]) ^ ZobristRowKey<Rows, Cols>(row, cells); // Only the changed row is rehashed
+    rows[row] = cells;
+}
+
+// Finds every column's top again from the bitboard, after rows moved
+// Scans down from the top row, stopping as soon as every column has been reached
+template <int Rows, int Cols, typename Mask>
+void BasicGrid<Rows, Cols, Mask>::ComputeColumnTops()
 {
-    for (int column = 0; column < numCols; column++) // Iterate through each column in the row
+    memset(columnTops, numRows, sizeof(columnTops));
+    Mask covered = emptyRow; // Columns whose top is known, and the walls
+    for (int row = 0; row < numRows && covered != (Mask)~0; row++)
     {
-        grid[row][column] = 0; // Set the cell to 0 (empty)
+        uint32_t reached = rows[row] & (Mask)~covered; // Columns whose highest cell is on this row
+        while (reached != 0)
+        {
+            columnTops[LowestBitIndex(reached) - wallWidth] = (unsigned char)row;
+            reached &= reached - 1;
+        }
+        covered |= rows[row];
     }
 }
 
-// Moves a row down by a specified number of rows
-void Grid::MoveRowDown(int row, int numRows)
+// Hashes the filled cells from scratch
+template <int Rows, int Cols, typename Mask>
+uint64_t BasicGrid<Rows, Cols, Mask>::ComputeHash() const
 {
-    for (int column = 0; column < numCols; column++) // Iterate through each column in the row
+    uint64_t fullHash = 0;
+    for (int row = 0; row < numRows; row++)
     {
-        grid[row + numRows][column] = grid[row][column]; // Move the cell value down
-        grid[row][column] = 0; // Clear the original cell
+        fullHash ^= ZobristRowKey<Rows, Cols>(row, rows[row]);
     }
+    return fullHash;
 }
 
+// The boards in use; other geometries need a line here
+template class BasicGrid<20, 10>;
+template class BasicGrid<40, 10>;
+template class BasicGrid<20, 16, uint32_t>;
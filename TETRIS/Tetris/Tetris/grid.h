@@ -1,11 +1,24 @@
 #pragma once // Ensures the header file is included only once during compilation
-#include <vector>   // Includes the vector container for managing collections of colors
-#include <raylib.h> // Includes the raylib library for rendering and the Color struct
+#include "bitboard.h" // Includes the RowMask type used for the bitboard rows
+#include "zobrist.h" // Includes the keys of the incremental board hash
 
-class Grid
+// A board whose geometry is fixed at compile time: Rows x Cols cells, one Mask per row
+// The sizes are constants, so the bounds checks fold and the row loops unroll for each board;
+// Mask must hold the playfield columns with at least wallWidth wall bits on each side
+// The member functions are defined in grid.cpp and instantiated there for the boards below
+template <int Rows, int Cols, typename Mask = RowMask>
+class BasicGrid
 {
+    static_assert(Cols + 2 * wallWidth <= (int)sizeof(Mask) * 8, "the mask must hold the columns and both walls");
+    static_assert(Rows <= 255, "column tops are stored in bytes");
+
 public:
-    Grid(); // Constructor: Initializes the grid with default values
+    static constexpr int numRows = Rows; // Number of rows in the grid
+    static constexpr int numCols = Cols; // Number of columns in the grid
+    // Mask of a row with no filled cells (only the wall bits set)
+    static constexpr Mask emptyRow = (Mask)~(Mask)((((uint32_t)1 << Cols) - 1) << wallWidth);
+
+    BasicGrid(); // Constructor: Initializes the grid with default values
 
     // Resets the grid by setting all cells to empty (value 0)
     void Initialize();
@@ -13,27 +26,55 @@ public:
     // Prints the grid to the console (useful for debugging)
     void Print();
 
-    // Draws the grid on the screen, rendering each cell with its corresponding color
-    void Draw();
-
     // Checks if a specific cell is outside the grid boundaries
     bool IsCellOutside(int row, int column);
 
     // Checks if a specific cell is empty (value 0)
     bool IsCellEmpty(int row, int column);
 
+    // Fills a cell with a block ID, updating both the bitboard and the color plane
+    void SetCell(int row, int column, int value);
+
+    // Returns the block ID stored in a cell (0 when empty)
+    int GetCell(int row, int column) const { return cellColors[row][column]; }
+
+    // Checks if a piece fits with masks[0] on the given row and its local column 0 on the given column
+    // Each mask holds one row of the piece (bit = local column); rows outside the grid never fit
+    bool PieceFits(int row, int column, const RowMask masks[4]) const;
+
     // Clears all full rows in the grid and returns the number of rows cleared
     int ClearFullRows();
 
-    // Getter for cellSize
-    int GetCellSize() const { return cellSize; }
+    // Pushes the stack up by count rows and fills the bottom rows with garbage: every cell filled with color
+    // except holeColumn; the whole board shifts in one block copy instead of row by row
+    // Returns false if filled cells were pushed out of the top (the player topped out)
+    bool AddGarbageRows(int count, int holeColumn, int color);
 
     // **New Getter for numRows**
-    int GetNumRows() const { return numRows; }
+    int GetNumRows() const { return Rows; }
+
+    // Getter for numCols
+    int GetNumCols() const { return Cols; }
+
+    // Mask of a row with no filled cells; its complement selects the playfield columns
+    Mask GetEmptyRow() const { return emptyRow; }
+
+    // Row of the highest filled cell of a column (GetNumRows() when the column is empty)
+    // Kept up to date by SetCell and ClearFullRows, so a block's landing row needs no collision steps
+    int GetColumnTop(int column) const { return columnTops[column]; }
 
-    // 2D array representing the grid, where each cell contains an integer value
+    // Zobrist hash of the filled cells, kept up to date by SetCell and ClearFullRows
+    uint64_t GetHash() const { return hash; }
+
+    // Hashes the filled cells from scratch; equals GetHash() (for checks)
+    uint64_t ComputeHash() const;
+
+    // Bitboard of the grid: one mask per row, with the wall bits outside the playfield always set
+    Mask rows[Rows];
+
+    // Color plane of the grid, used only for rendering
     // 0 indicates an empty cell, and other values correspond to block IDs
-    int grid[20][10];
+    unsigned char cellColors[Rows][Cols];
 
 private:
     // Checks if a specific row is full (no empty cells)
@@ -43,10 +84,29 @@ private:
     void ClearRow(int row);
 
     // Moves a row down by a specified number of rows
-    void MoveRowDown(int row, int numRows);
+    void MoveRowDown(int row, int distance);
+
+    // Replaces a row's mask, swapping its key in the hash
+    void SetRow(int row, Mask cells);
+
+    // Finds every column's top again from the bitboard, after rows moved
+    void ComputeColumnTops();
 
-    int numRows; // Number of rows in the grid
-    int numCols; // Number of columns in the grid
-    int cellSize; // Size of each cell in the grid (e.g., 30x30 pixels)
-    std::vector<Color> colors; // Vector of colors used to render the grid cells
+    uint64_t hash; // Zobrist hash of the filled cells (0 for an empty grid)
+    unsigned char columnTops[Cols]; // Row of the highest filled cell of each column (numRows when empty)
 };
+
+// The standard board the game is played on
+typedef BasicGrid<20, 10> Grid;
+
+// A 40-row geometry, benchmarked to see how the row loops scale with the height
+// Game plays on Grid only: nothing spawns blocks in or hides a buffer zone above the standard rows
+typedef BasicGrid<40, 10> TallGrid;
+
+// A wide 16-column variant; its rows need 32-bit masks
+typedef BasicGrid<20, 16, uint32_t> WideGrid;
+
+// Instantiated once, in grid.cpp
+extern template class BasicGrid<20, 10>;
+extern template class BasicGrid<40, 10>;
+extern template class BasicGrid<20, 16, uint32_t>;
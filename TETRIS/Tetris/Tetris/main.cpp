@@ -1,102 +1,205 @@
 #include <raylib.h> // Includes the raylib library for rendering and game utilities
 #include "game.h"   // Includes the Game class for managing game logic
+#include "gameview.h" // Includes the GameView class for drawing, input and audio
+#include "versus.h" // Includes the split-screen versus match
+#include "bot.h"    // Includes the autoplay bot and its worker thread
+#include "mappedfile.h" // Includes the mapped file the replays are played from
+#include "replay.h" // Includes the replay recorder and reader
 #include "colors.h" // Includes color definitions for rendering
+#include "timestep.h" // Includes the fixed-timestep clock gravity runs on
+#include "assets.h" // Includes the asset manager loading the fonts, images and sounds
+#include "uicache.h" // Includes the cached screens and labels, and the stroked text and panels
+#include "perfoverlay.h" // Includes the frame timings overlay (compiled out without TETRIS_PERF_OVERLAY)
+#include "trace.h"  // Includes the session trace and its spans
 #include <iostream> // Includes the iostream library for debugging (if needed)
+#include <cstdio>   // Includes snprintf for formatting the score
+#include <ctime>    // Includes time for seeding the block sequence
 
-// Global variable to track the last update time for timed events
-double lastUpdateTime = 0;
+// Simulation clock: gravity runs on fixed steps of simulated time, however fast frames are drawn
+FixedTimestep simulation;
 
-// Function to check if a specific time interval has passed
-bool EventTriggered(double interval)
+// Simulated time since the last gravity tick
+double gravityTime = 0;
+
+// Runs the simulation steps due since the last frame; gravity drops the block each time its interval has passed,
+// as many times as needed to catch up after a slow frame
+void StepSimulation(Game& game, ReplayRecorder& recorder)
 {
-    double currentTime = GetTime(); // Get the current time in seconds
-    if (currentTime - lastUpdateTime >= interval) // Check if the interval has passed
+    PERF_SCOPE(PERF_SIMULATION);
+    TRACE_SPAN("simulation");
+    int steps = simulation.Advance(GetTime());
+    for (int i = 0; i < steps && !game.gameOver; i++)
     {
-        lastUpdateTime = currentTime; // Update the last update time
-        return true; // Return true if the event is triggered
+        gravityTime += simulation.GetStep();
+        double interval = CalculationInterval(game.score); // Calculate the interval based on the score
+        if (gravityTime >= interval) // Check if the interval has passed
+        {
+            gravityTime -= interval;
+            game.MoveBlockDown(); // Move the current block down
+            recorder.RecordGravity(GetTime()); // Stamped with the frame, after the frame's inputs, so event times never go back
+        }
     }
-    return false; // Return false otherwise
 }
 
-// Function to calculate the interval based on the score
-double CalculationInterval(int score)
+// How far the block has fallen towards the next row, in rows, for drawing it between rows
+float FallProgress(const Game& game)
 {
-    // Base interval is 0.8 seconds, decrease as score increases
-    double interval = 0.8 - (score / 1000.0); // Adjust the divisor to control speed scaling
-    return interval > 0.2 ? interval : 0.32;  // Ensure a minimum interval of 0.5 seconds
+    double progress = (gravityTime + simulation.GetAlpha() * simulation.GetStep()) / CalculationInterval(game.score);
+    return progress < 1.0 ? static_cast<float>(progress) : 1.0f;
 }
 
-// Draws a rounded rectangle with a stroke
-void DrawRectangleRoundedWithStroke(Rectangle rect, float roundness, int segments, Color fillColor, Color strokeColor, float strokeThickness)
+// Where the last finished or abandoned game's replay is saved
+const char* lastReplayPath = "last_game.trp";
+
+// Where F4 records a session trace, for chrome://tracing or Perfetto
+const char* tracePath = "trace.json";
+
+// Starts a new game with a fresh seed and records it
+void StartRecordedGame(Game& game, ReplayRecorder& recorder)
 {
-    // Draw the stroke (outer rectangle)
-    DrawRectangleRounded(rect, roundness, segments, strokeColor);
-
-    // Adjust the rectangle size for the inner fill
-    Rectangle innerRect = {
-        rect.x + strokeThickness,
-        rect.y + strokeThickness,
-        rect.width - 2 * strokeThickness,
-        rect.height - 2 * strokeThickness
-    };
-
-    // Draw the inner rectangle (fill)
-    DrawRectangleRounded(innerRect, roundness, segments, fillColor);
+    uint64_t seed = (uint64_t)time(nullptr); // A different block sequence every game
+    game.Reset(seed);
+    recorder.Start(seed, GetTime());
+    simulation.Reset(GetTime()); // The first gravity tick is a full interval away
+    gravityTime = 0;
 }
 
-// Draws text with a stroke
-void DrawTextWithStroke(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color textColor, Color strokeColor, float strokeThickness)
+// Ends the recording of the current game and saves it
+void SaveRecordedGame(const Game& game, ReplayRecorder& recorder)
 {
-    // Draw the stroke by rendering the text multiple times around the main text
-    for (int dy = -static_cast<int>(strokeThickness); dy <= static_cast<int>(strokeThickness); dy++)
+    if (recorder.IsRecording())
     {
-        for (int dx = -static_cast<int>(strokeThickness); dx <= static_cast<int>(strokeThickness); dx++)
-        {
-            if (dx != 0 || dy != 0) // Skip the center position
-            {
-                DrawTextEx(font, text, { position.x + dx, position.y + dy }, fontSize, spacing, strokeColor);
-            }
-        }
+        recorder.Finish(game);
+        recorder.Save(lastReplayPath); // A failed save only loses the replay
     }
+}
+
+// Size of the window outside versus play
+const int screenWidth = 500;
+const int screenHeight = 620;
 
-    // Draw the main text in the center
-    DrawTextEx(font, text, position, fontSize, spacing, textColor);
+// Starts a versus match, widening the window to one panel per player; matches are not recorded
+void StartVersusMatch(Match& match, int numPlayers)
+{
+    match.Start(numPlayers, (uint64_t)time(nullptr));
+    simulation.Reset(GetTime()); // Gravity shares the simulation clock with single play
+    SetWindowSize(numPlayers * versusPanelWidth, versusScreenHeight);
 }
 
 // Enum to represent the different game states
-enum GameState { MAIN_MENU, PLAYING, GAME_OVER, HOW_TO_PLAY, PAUSE };
+enum GameState { MAIN_MENU, PLAYING, GAME_OVER, HOW_TO_PLAY, PAUSE, AUTOPLAY, REPLAY, VERSUS_SETUP, VERSUS };
+
+// Text that changes while a screen is shown, each cached in its own label
+enum UiLabel { LABEL_SCORE, LABEL_BOT_TIME, LABEL_BOT_MAX, LABEL_BOT_GAMES, LABEL_REPLAY_SPEED, LABEL_REPLAY_STATUS, LABEL_FINAL_SCORE };
 
 int main()
 {
     // Initialize the game window
-    InitWindow(500, 620, "Tetris Game");
+    InitWindow(screenWidth, screenHeight, "Tetris Game");
     SetTargetFPS(90); // Set the target frames per second
+    SetTraceThreadName("main");
 
-    // Load resources (textures and fonts) once before the game loop
-    Font font = LoadFontEx("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetris-game-main/TETRIS/Tetris/Font/amm.ttf", 64, 0, 0);
-    Texture2D BG1 = LoadTexture("C:/Users/salon/Downloads/Tetris-game-main (1)/Tetriss.png");
-    Texture2D BG2 = LoadTexture("C:/Users/salon/Downloads/Tetris-game-main (1)/sky.jpg");
-    Texture2D BG3 = LoadTexture("C:/Users/salon/Downloads/Tetris-game-main (1)/pic1.jpg");
+    // Find the fonts, images and sounds and load them in the background; the menu shows meanwhile
+    AssetManager assets;
 
     // Initialize the game object and variables
     Game game = Game();
+    game.Reset((uint64_t)time(nullptr)); // A different block sequence every launch
+    AudioEngine audio(assets); // Opens the audio device; streams the music on its own thread
+    GameView view(audio); // Draws the game and plays its sounds
+    UiCache ui; // Each screen's fixed content, drawn once, and the text that changes on it
     bool isPaused = false; // Tracks whether the game is paused
+    bool smoothFall = false; // Draw the falling block between rows, interpolated from the simulation clock
     GameState gameState = MAIN_MENU; // Start in the main menu
 
+    // Autoplay: the bot thinks on its own thread and the loop feeds its inputs to the game
+    BotThread bot; // Heuristic player searching off the render thread
+    BotDecision plan; // Inputs of the bot's latest decision
+    int planStep = 0; // Next input of the plan to apply
+    bool hasPlan = false; // The plan is for the current block and still has inputs
+    int botTicket = 0; // Ticket of the request the loop is waiting for (0 = none)
+    double botSeconds = 0; // Latency of the last decision
+    int botDepth = 0; // Blocks the last decision looked ahead
+    double maxBotSeconds = 0; // Slowest decision this game
+    int botGames = 0; // Games the bot has finished since autoplay started
+    bool botFast = false; // Apply a whole plan in one frame instead of one input per frame
+
+    // Replays: every game played is recorded, and the last one can be watched again
+    ReplayRecorder recorder; // Records the game being played
+    MappedFile replayFile; // The replay being watched
+    ReplayReader replayReader(nullptr, 0); // Reads the events of the replay being watched
+    ReplayEvent replayEvent; // Next event to apply
+    bool hasReplayEvent = false; // replayEvent holds an event not applied yet
+    double replayStart = 0; // Time the playback started
+    double replayClock = 0; // Playback time in seconds, running faster when fast forwarding
+    bool replayFast = false; // Play at eight times the recorded speed
+    const char* replayStatus = ""; // Result of the playback once it ended
+
+    // Versus: two to four players on one keyboard, each board drawn from one shared texture
+    Match match; // The boards and the garbage between them
+    VersusView versusView; // Draws every board of the match in a few batched passes
+
     // Main game loop
     while (!WindowShouldClose()) // Loop until the window is closed
     {
+        PERF_BEGIN_FRAME(); // Close the last frame's timings; F3 shows them
+        TRACE_BEGIN(frameSpan, "frame"); // Ends with the loop body
+
+        if (IsKeyPressed(KEY_F4)) // Start or stop recording a session trace
+        {
+            if (IsTracing())
+            {
+                StopTrace();
+                TraceLog(LOG_INFO, "TRACE: Saved %s", tracePath);
+            }
+            else if (StartTrace(tracePath))
+            {
+                TraceLog(LOG_INFO, "TRACE: Recording %s", tracePath);
+            }
+        }
+
         // Handle input and update game state
+        TRACE_BEGIN(updateSpan, "update");
         if (gameState == MAIN_MENU)
         {
             if (IsKeyPressed(KEY_ENTER)) // Start the game
             {
+                StartRecordedGame(game, recorder);
                 gameState = PLAYING;
             }
+            else if (IsKeyPressed(KEY_P)) // Watch the last game again
+            {
+                replayReader = ReplayReader(nullptr, 0);
+                if (replayFile.Open(lastReplayPath))
+                {
+                    replayReader = ReplayReader(replayFile.GetData(), replayFile.GetSize());
+                }
+                if (replayReader.IsValid())
+                {
+                    game.Reset(replayReader.GetSeed()); // The same blocks as the recorded game
+                    hasReplayEvent = replayReader.Next(replayEvent);
+                    replayStart = GetTime();
+                    replayClock = 0;
+                    replayStatus = "";
+                    gameState = REPLAY;
+                }
+            }
             else if (IsKeyPressed(KEY_H)) // Show "How to Play"
             {
                 gameState = HOW_TO_PLAY;
             }
+            else if (IsKeyPressed(KEY_V)) // Pick the players of a versus match
+            {
+                gameState = VERSUS_SETUP;
+            }
+            else if (IsKeyPressed(KEY_A)) // Let the bot play (attract mode and soak test)
+            {
+                game.Reset((uint64_t)time(nullptr));
+                gameState = AUTOPLAY;
+                hasPlan = false;
+                maxBotSeconds = 0;
+                botGames = 0;
+            }
         }
         else if (gameState == HOW_TO_PLAY)
         {
@@ -105,10 +208,59 @@ int main()
                 gameState = MAIN_MENU;
             }
         }
+        else if (gameState == VERSUS_SETUP)
+        {
+            if (IsKeyPressed(KEY_BACKSPACE)) // Return to the main menu
+            {
+                gameState = MAIN_MENU;
+            }
+            for (int players = 2; players <= maxVersusPlayers; players++) // "2" to "4" starts a match with that many players
+            {
+                if (IsKeyPressed(KEY_ZERO + players))
+                {
+                    StartVersusMatch(match, players);
+                    gameState = VERSUS;
+                }
+            }
+        }
+        else if (gameState == VERSUS)
+        {
+            if (IsKeyPressed(KEY_BACKSPACE)) // Return to the main menu, in the single board's window
+            {
+                SetWindowSize(screenWidth, screenHeight);
+                gameState = MAIN_MENU;
+            }
+            else if (match.IsOver())
+            {
+                if (IsKeyPressed(KEY_R)) // Rematch with the same players
+                {
+                    StartVersusMatch(match, match.GetNumPlayers());
+                }
+            }
+            else
+            {
+                for (int player = 0; player < match.GetNumPlayers(); player++)
+                {
+                    view.Update(match.GetPlayer(player)); // Play each board's sounds
+                    HandleVersusInput(match.GetPlayer(player), versusKeys[player]);
+                }
+
+                // Gravity for the time since the last frame, then the garbage the frame's clears sent
+                PERF_SCOPE(PERF_SIMULATION);
+                TRACE_SPAN("simulation");
+                int steps = simulation.Advance(GetTime());
+                for (int i = 0; i < steps; i++)
+                {
+                    match.StepGravity(simulation.GetStep());
+                }
+                match.SendGarbage();
+            }
+        }
         else if (gameState == PLAYING)
         {
             if (game.gameOver) // Check if the game is over
             {
+                SaveRecordedGame(game, recorder); // Keep the replay of the game just lost
                 gameState = GAME_OVER; // Transition to the GAME_OVER state
             }
             else
@@ -119,15 +271,110 @@ int main()
                     isPaused = true;
                 }
 
-                UpdateMusicStream(game.music); // Update the background music stream
+                view.Update(game); // Play the game's sounds
 
                 if (!isPaused) // If the game is not paused
                 {
-                    game.HandleInput(); // Handle player input
-                    double interval = CalculationInterval(game.score); // Calculate the interval based on the score
-                    if (EventTriggered(interval)) // Check if the interval has passed
+                    GameInput input;
+                    if (view.HandleInput(game, input)) // Handle player input
+                    {
+                        recorder.RecordInput(input, GetTime());
+                    }
+                    if (IsKeyPressed(KEY_I)) // Toggle drawing the block between rows as it falls
                     {
-                        game.MoveBlockDown(); // Move the current block down
+                        smoothFall = !smoothFall;
+                    }
+                    StepSimulation(game, recorder); // Apply gravity for the time since the last frame
+                }
+            }
+        }
+        else if (gameState == AUTOPLAY)
+        {
+            if (IsKeyPressed(KEY_M)) // Return to the main menu; a pending decision is dropped by its ticket
+            {
+                game.Reset();
+                gameState = MAIN_MENU;
+                hasPlan = false;
+                botTicket = 0;
+            }
+            else
+            {
+                if (IsKeyPressed(KEY_F)) // Toggle fast play
+                {
+                    botFast = !botFast;
+                }
+                if (game.gameOver) // Attract mode never stops: start the next game
+                {
+                    game.Reset((uint64_t)time(nullptr));
+                    botGames++;
+                    hasPlan = false;
+                    botTicket = 0;
+                    maxBotSeconds = 0;
+                }
+
+                view.Update(game); // Play the game's sounds
+
+                // Ask for a decision once per block, then poll; the search never runs on this thread
+                PERF_SCOPE(PERF_SIMULATION);
+                // There is no gravity here: the bot's inputs end with a drop
+                if (!hasPlan && botTicket == 0)
+                {
+                    botTicket = bot.Request(game);
+                }
+                if (botTicket != 0 && bot.TakeDecision(plan) && plan.ticket == botTicket)
+                {
+                    botTicket = 0;
+                    hasPlan = true;
+                    planStep = 0;
+                    botSeconds = plan.seconds;
+                    botDepth = plan.depth;
+                    maxBotSeconds = plan.seconds > maxBotSeconds ? plan.seconds : maxBotSeconds;
+                }
+                if (hasPlan)
+                {
+                    if (plan.numInputs == 0) // Nothing fits; dropping ends the game
+                    {
+                        game.ApplyInput(INPUT_DROP);
+                    }
+                    int steps = botFast ? plan.numInputs - planStep : 1; // One input per frame, so the moves are visible
+                    for (int i = 0; i < steps && planStep < plan.numInputs; i++)
+                    {
+                        game.ApplyInput(plan.inputs[planStep++]);
+                    }
+                    hasPlan = planStep < plan.numInputs;
+                }
+            }
+        }
+        else if (gameState == REPLAY)
+        {
+            if (IsKeyPressed(KEY_M)) // Return to the main menu
+            {
+                game.Reset();
+                replayFile.Close();
+                gameState = MAIN_MENU;
+            }
+            else
+            {
+                if (IsKeyPressed(KEY_F)) // Toggle fast forward
+                {
+                    replayFast = !replayFast;
+                }
+                view.Update(game); // Play the game's sounds
+
+                // Apply every event whose time has come; the events alone decide the game, the times only pace it
+                PERF_SCOPE(PERF_SIMULATION);
+                double now = GetTime();
+                replayClock += (now - replayStart) * (replayFast ? 8.0 : 1.0);
+                replayStart = now;
+                while (hasReplayEvent && replayEvent.timeMs <= replayClock * 1000.0)
+                {
+                    ApplyReplayEvent(game, replayEvent);
+                    hasReplayEvent = replayReader.Next(replayEvent);
+                    if (!hasReplayEvent) // The end: check the game ended exactly as recorded
+                    {
+                        ReplaySummary recorded;
+                        bool same = replayReader.ReadSummary(recorded) && SummariesMatch(SummarizeGame(game), recorded);
+                        replayStatus = same ? "REPLAY OK" : "REPLAY MISMATCH";
                     }
                 }
             }
@@ -136,17 +383,20 @@ int main()
         {
             if (IsKeyPressed(KEY_B)) // Resume the game
             {
+                simulation.Reset(GetTime()); // The pause does not count as simulated time
                 gameState = PLAYING;
                 isPaused = false;
             }
             else if (IsKeyPressed(KEY_R)) // Retry the game
             {
-                game.Reset();
+                SaveRecordedGame(game, recorder); // Keep the replay of the abandoned game
+                StartRecordedGame(game, recorder);
                 gameState = PLAYING;
                 isPaused = false;
             }
             else if (IsKeyPressed(KEY_M)) // Return to the main menu
             {
+                SaveRecordedGame(game, recorder);
                 game.Reset();
                 gameState = MAIN_MENU;
                 isPaused = false;
@@ -156,7 +406,7 @@ int main()
         {
             if (IsKeyPressed(KEY_R)) // Retry the game
             {
-                game.Reset();
+                StartRecordedGame(game, recorder);
                 gameState = PLAYING;
             }
             else if (IsKeyPressed(KEY_M)) // Return to the main menu
@@ -166,74 +416,177 @@ int main()
             }
         }
 
+        TRACE_END(updateSpan);
+        PERF_PHASE(PERF_OTHER);
+
+        // Take the assets loaded since the last frame; the screens painted without them are painted again
+        TRACE_BEGIN(assetsSpan, "assets");
+        if (assets.Update())
+        {
+            ui.Invalidate();
+            audio.TakeEffects();
+        }
+        TRACE_END(assetsSpan);
+        audio.SetMusicPaused(gameState == PAUSE); // The music stops with the game
+        Font font = assets.GetFont(ASSET_FONT); // raylib's default font until it is loaded
+        Texture2D BG1 = assets.GetTexture(ASSET_MENU_BACKGROUND); // Empty, and drawn as nothing, until loaded
+        Texture2D BG2 = assets.GetTexture(ASSET_GAME_BACKGROUND);
+        Texture2D BG3 = assets.GetTexture(ASSET_HELP_IMAGE);
+
         // Begin rendering the frame
+        PERF_PHASE(PERF_DRAW_UI);
+        TRACE_BEGIN(drawSpan, "draw");
         BeginDrawing();
         ClearBackground(DARKGRAY); // Clear the screen with a dark gray background
 
         // Render based on the current game state
+        // Each screen's background, panels and fixed labels are painted into its layer the first time it is shown
         if (gameState == MAIN_MENU)
         {
-            DrawTexture(BG1, 0, 0, WHITE); // Draw the main menu background
-            DrawRectangleRoundedWithStroke({ 100, 480, 300, 60 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw a button
-            DrawTextWithStroke(font, "Press \"ENTER\" to Play", { 135, 500 }, 25, 2, WHITE, BLACK, 2); // Draw text
-            DrawTextWithStroke(font, "Press \"H\" for How to play ", { 120, 450 }, 25, 2, GREEN, BLACK, 2);
-            DrawTextWithStroke(font, "Press \"ESCAPE\" to Quit", { 133, 550 }, 25, 2, RED, BLACK, 2);
+            if (ui.BeginLayer(MAIN_MENU))
+            {
+                ClearBackground(DARKGRAY);
+                DrawTexture(BG1, 0, 0, WHITE); // Draw the main menu background
+                DrawRectangleRoundedWithStroke({ 100, 480, 300, 60 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw a button
+                DrawTextWithStroke(font, "Press \"ENTER\" to Play", { 135, 500 }, 25, 2, WHITE, BLACK, 2); // Draw text
+                DrawTextWithStroke(font, "Press \"H\" for How to play ", { 120, 450 }, 25, 2, GREEN, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"A\" to watch the bot", { 125, 410 }, 25, 2, YELLOW, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"P\" to replay the last game", { 95, 370 }, 25, 2, SKYBLUE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"V\" for versus (2-4 players)", { 95, 330 }, 25, 2, ORANGE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"ESCAPE\" to Quit", { 133, 550 }, 25, 2, RED, BLACK, 2);
+                ui.EndLayer();
+            }
+            ui.DrawLayer(MAIN_MENU);
         }
         else if (gameState == PAUSE)
         {
-            DrawTextureEx(BG2, { 0, 0 }, 0.0f, 0.7f, WHITE); // Draw the pause screen background
-            DrawTextWithStroke(font, "PAUSED", { 155, 100 }, 80, 5, WHITE, BLACK, 5); // Draw "PAUSED" text
-            DrawTextWithStroke(font, "Press \"B\" to Back", { 165, 500 }, 25, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "Press \"M\" Back to Main Menu", { 80, 450 }, 30, 2, WHITE, BLACK, 2);
+            if (ui.BeginLayer(PAUSE))
+            {
+                ClearBackground(DARKGRAY);
+                DrawTextureEx(BG2, { 0, 0 }, 0.0f, 0.7f, WHITE); // Draw the pause screen background
+                DrawTextWithStroke(font, "PAUSED", { 155, 100 }, 80, 5, WHITE, BLACK, 5); // Draw "PAUSED" text
+                DrawTextWithStroke(font, "Press \"B\" to Back", { 165, 500 }, 25, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"M\" Back to Main Menu", { 80, 450 }, 30, 2, WHITE, BLACK, 2);
+                ui.EndLayer();
+            }
+            ui.DrawLayer(PAUSE);
         }
         else if (gameState == HOW_TO_PLAY)
         {
-            DrawRectangleRounded({ 2, 10, 495, 600 }, 0, 6, DARKGRAY); // Draw a background for the "How to Play" screen
-            DrawTextureEx(BG3, { 0, -300 }, 0.0f, 0.9f, WHITE); // Draw an image
-            DrawTextWithStroke(font, "HOW TO PLAY", { 145, 50 }, 50, 2, WHITE, BLACK, 2); // Draw the title
-            DrawTextWithStroke(font, "- PRESS \"A/D\" or Left/Right to move blocks", { 20, 130 }, 24, 2, WHITE, BLACK, 2); // Instructions
-            DrawTextWithStroke(font, "- PRESS \"W or Up\" to rotate blocks", { 20, 160 }, 24, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "- PRESS \"S or Down\" to move blocks down", { 20, 190 }, 24, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "- Press \"SPACE\" to drop blocks", { 20, 220 }, 24, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "- Press \"TAB\" to pause the game", { 20, 250 }, 24, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "Press \"BACKSPACE\" to return to the main menu", { 25, 570 }, 24, 2, WHITE, BLACK, 2);
+            if (ui.BeginLayer(HOW_TO_PLAY))
+            {
+                ClearBackground(DARKGRAY);
+                DrawRectangleRounded({ 2, 10, 495, 600 }, 0, 6, DARKGRAY); // Draw a background for the "How to Play" screen
+                DrawTextureEx(BG3, { 0, -300 }, 0.0f, 0.9f, WHITE); // Draw an image
+                DrawTextWithStroke(font, "HOW TO PLAY", { 145, 50 }, 50, 2, WHITE, BLACK, 2); // Draw the title
+                DrawTextWithStroke(font, "- PRESS \"A/D\" or Left/Right to move blocks", { 20, 130 }, 24, 2, WHITE, BLACK, 2); // Instructions
+                DrawTextWithStroke(font, "- PRESS \"W or Up\" to rotate blocks", { 20, 160 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- PRESS \"S or Down\" to move blocks down", { 20, 190 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- Press \"SPACE\" to drop blocks", { 20, 220 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- Press \"TAB\" to pause the game", { 20, 250 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- Press \"I\" for smooth falling", { 20, 280 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- Bot mode: \"F\" fast play, \"M\" main menu", { 20, 310 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- Replay: \"F\" fast forward, \"M\" main menu", { 20, 340 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "- Versus: clear rows to send garbage", { 20, 370 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"BACKSPACE\" to return to the main menu", { 25, 570 }, 24, 2, WHITE, BLACK, 2);
+                ui.EndLayer();
+            }
+            ui.DrawLayer(HOW_TO_PLAY);
         }
-        else if (gameState == PLAYING)
+        else if (gameState == PLAYING || gameState == AUTOPLAY || gameState == REPLAY)
         {
-            DrawTextureEx(BG2, { 0, 0 }, 0.0f, 0.7f, WHITE); // Draw the game background
-            DrawTextWithStroke(font, "SCORE", { 365, 15 }, 30, 2, WHITE, BLACK, 2); // Draw the score label
-            DrawRectangleRoundedWithStroke({ 320, 140, 170, 180 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw the "next block" area
-            DrawTextWithStroke(font, "NEXT", { 380, 160 }, 30, 2, WHITE, BLACK, 2); // Draw the "NEXT" label
-            DrawRectangleRoundedWithStroke({ 320, 50, 170, 60 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw the score area
+            if (ui.BeginLayer(PLAYING)) // The three screens share the playing layer
+            {
+                ClearBackground(DARKGRAY);
+                DrawTextureEx(BG2, { 0, 0 }, 0.0f, 0.7f, WHITE); // Draw the game background
+                DrawTextWithStroke(font, "SCORE", { 365, 15 }, 30, 2, WHITE, BLACK, 2); // Draw the score label
+                DrawRectangleRoundedWithStroke({ 320, 140, 170, 180 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw the "next block" area
+                DrawTextWithStroke(font, "NEXT", { 380, 160 }, 30, 2, WHITE, BLACK, 2); // Draw the "NEXT" label
+                DrawRectangleRoundedWithStroke({ 320, 335, 170, 200 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw the "later blocks" area
+                DrawRectangleRoundedWithStroke({ 320, 50, 170, 60 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw the score area
+                ui.EndLayer();
+            }
+            ui.DrawLayer(PLAYING);
 
-            // Draw the score
-            char scoreText[10];
-            sprintf_s(scoreText, sizeof(scoreText), "%d", game.score);
-            Vector2 textSize = MeasureTextEx(font, scoreText, 38, 2);
-            DrawTextEx(font, scoreText, { 320 + (170 - textSize.x) / 2, 65 }, 38, 2, WHITE);
+            // Draw the score, centered in the score area
+            char scoreText[12];
+            snprintf(scoreText, sizeof(scoreText), "%d", game.score);
+            ui.DrawLabel(LABEL_SCORE, PLAYING, font, scoreText, { 320, 65 }, 170, 38, 2, WHITE, BLACK, 0);
 
-            game.Draw(); // Draw the game grid and blocks
+            view.Draw(game, gameState == PLAYING && smoothFall ? FallProgress(game) : 0.0f); // Draw the game grid and blocks
+
+            if (gameState == AUTOPLAY) // Show how long the bot takes to decide on a block
+            {
+                char botText[32];
+                snprintf(botText, sizeof(botText), "BOT %.2f ms d%d", botSeconds * 1000, botDepth);
+                ui.DrawLabel(LABEL_BOT_TIME, PLAYING, font, botText, { 325, 545 }, 0, 22, 2, YELLOW, BLACK, 2);
+                snprintf(botText, sizeof(botText), "max %.2f ms", maxBotSeconds * 1000);
+                ui.DrawLabel(LABEL_BOT_MAX, PLAYING, font, botText, { 325, 568 }, 0, 20, 2, WHITE, BLACK, 2);
+                snprintf(botText, sizeof(botText), "games %d%s", botGames, botFast ? "  fast" : "");
+                ui.DrawLabel(LABEL_BOT_GAMES, PLAYING, font, botText, { 325, 590 }, 0, 20, 2, WHITE, BLACK, 2);
+            }
+            if (gameState == REPLAY) // Show the playback speed, then whether the game ended as recorded
+            {
+                ui.DrawLabel(LABEL_REPLAY_SPEED, PLAYING, font, replayFast ? "REPLAY x8" : "REPLAY", { 325, 545 }, 0, 22, 2, SKYBLUE, BLACK, 2);
+                ui.DrawLabel(LABEL_REPLAY_STATUS, PLAYING, font, replayStatus, { 325, 568 }, 0, 20, 2, WHITE, BLACK, 2);
+            }
+        }
+        else if (gameState == VERSUS_SETUP)
+        {
+            if (ui.BeginLayer(VERSUS_SETUP))
+            {
+                ClearBackground(DARKGRAY);
+                DrawTextureEx(BG2, { 0, 0 }, 0.0f, 0.7f, WHITE); // Draw the game background
+                DrawTextWithStroke(font, "VERSUS", { 150, 50 }, 60, 2, WHITE, BLACK, 3); // Draw the title
+                DrawTextWithStroke(font, "Clear 2, 3 or 4 rows to send", { 20, 140 }, 24, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "1, 2 or 4 garbage rows to the next player", { 20, 170 }, 24, 2, WHITE, BLACK, 2);
+                for (int player = 0; player < maxVersusPlayers; player++) // Each player's keys
+                {
+                    DrawTextWithStroke(font, TextFormat("P%d: %s", player + 1, versusKeys[player].names),
+                        { 20, 230 + player * 35.0f }, 24, 2, YELLOW, BLACK, 2);
+                }
+                DrawRectangleRoundedWithStroke({ 50, 420, 400, 60 }, 0.3f, 6, GRAY, BLACK, 3.0f); // Draw a button
+                DrawTextWithStroke(font, "Press \"2\", \"3\" or \"4\" for the players", { 70, 440 }, 25, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"BACKSPACE\" to return to the main menu", { 25, 570 }, 24, 2, WHITE, BLACK, 2);
+                ui.EndLayer();
+            }
+            ui.DrawLayer(VERSUS_SETUP);
+        }
+        else if (gameState == VERSUS)
+        {
+            versusView.Draw(match, font); // Every board in a few batched passes
+            PERF_COUNT_DRAWS(1);
+            DrawTextEx(font, match.IsOver() ? "Press \"R\" for a rematch, \"BACKSPACE\" for the main menu" : "Press \"BACKSPACE\" for the main menu",
+                { 20, 590 }, 20, 2, WHITE); // In the same font as the boards' text, so it joins their batch
         }
         else if (gameState == GAME_OVER)
         {
-            ClearBackground(RED); // Set the background to red
-            DrawTextWithStroke(font, "GAME OVER", { 100, 100 }, 80, 2, WHITE, BLACK, 3); // Draw "GAME OVER"
+            if (ui.BeginLayer(GAME_OVER))
+            {
+                ClearBackground(RED); // Set the background to red
+                DrawTextWithStroke(font, "GAME OVER", { 100, 100 }, 80, 2, WHITE, BLACK, 3); // Draw "GAME OVER"
+                DrawTextWithStroke(font, "Press \"R\" to Retry", { 40, 400 }, 30, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"M\" Back to Main Menu", { 40, 450 }, 30, 2, WHITE, BLACK, 2);
+                DrawTextWithStroke(font, "Press \"ESCAPE\" to Quit", { 133, 550 }, 25, 2, WHITE, BLACK, 2);
+                ui.EndLayer();
+            }
+            ui.DrawLayer(GAME_OVER);
             char scoreText[20];
-            sprintf_s(scoreText, sizeof(scoreText), "Score: %d", game.score); // Display the final score
-            DrawTextWithStroke(font, scoreText, { 40, 300 }, 40, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "Press \"R\" to Retry", { 40, 400 }, 30, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "Press \"M\" Back to Main Menu", { 40, 450 }, 30, 2, WHITE, BLACK, 2);
-            DrawTextWithStroke(font, "Press \"ESCAPE\" to Quit", { 133, 550 }, 25, 2, WHITE, BLACK, 2);
+            snprintf(scoreText, sizeof(scoreText), "Score: %d", game.score); // Display the final score
+            ui.DrawLabel(LABEL_FINAL_SCORE, GAME_OVER, font, scoreText, { 40, 300 }, 0, 40, 2, WHITE, BLACK, 2);
         }
 
+        PERF_DRAW_OVERLAY(); // Over everything else, when shown
+        TRACE_END(drawSpan);
+        PERF_PHASE(PERF_PRESENT);
+        TRACE_BEGIN(presentSpan, "present"); // Ends with the frame
         EndDrawing(); // End rendering the frame
     }
 
-    // Unload resources after the game loop ends
-    UnloadTexture(BG1);
-    UnloadTexture(BG2); 
-    UnloadTexture(BG3);
-    UnloadFont(font);
+    StopTrace(); // Finish a trace still recording
+
+    // Unload resources after the game loop ends, while the window and the audio device are open
+    assets.Unload();
 
     // Close the game window
     CloseWindow();
@@ -0,0 +1,129 @@
+#include "mappedfile.h" // Includes the header file for the mapped file
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h> // Includes CreateFileMapping and MapViewOfFile
+#else
+#include <fcntl.h>    // Includes open
+#include <sys/mman.h> // Includes mmap and munmap
+#include <sys/stat.h> // Includes fstat for the file size
+#include <unistd.h>   // Includes close
+#endif
+
+// Constructor: Maps nothing
+MappedFile::MappedFile()
+{
+    data = nullptr;
+    size = 0;
+#ifdef _WIN32
+    file = INVALID_HANDLE_VALUE;
+    mapping = nullptr;
+#endif
+}
+
+// Destructor: Unmaps the file
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+// Maps a whole file, replacing any mapped one
+bool MappedFile::Open(const char* path)
+{
+    Close();
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length))
+    {
+        Close();
+        return false;
+    }
+    size = (size_t)length.QuadPart;
+    if (size == 0) // Empty files cannot be mapped, and need not be
+    {
+        return true;
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+// Unmaps the file
+void MappedFile::Close()
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+    if (mapping != nullptr)
+    {
+        CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+    }
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+}
+#else
+// Maps a whole file, replacing any mapped one
+bool MappedFile::Open(const char* path)
+{
+    Close();
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0)
+    {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        return false;
+    }
+    size = (size_t)status.st_size;
+    if (size > 0) // Empty files cannot be mapped, and need not be
+    {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapped == MAP_FAILED)
+        {
+            size = 0;
+            close(descriptor);
+            return false;
+        }
+        data = (const unsigned char*)mapped;
+        madvise(mapped, size, MADV_SEQUENTIAL); // Replays and archives are read front to back
+    }
+    close(descriptor); // The mapping keeps the file alive
+    return true;
+}
+
+// Unmaps the file
+void MappedFile::Close()
+{
+    if (data != nullptr)
+    {
+        munmap((void*)data, size);
+    }
+    data = nullptr;
+    size = 0;
+}
+#endif
@@ -0,0 +1,29 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <cstddef> // Includes size_t for the file size
+
+// A read-only file mapped into memory: its bytes are read straight from the page cache, with no copy
+class MappedFile
+{
+public:
+    MappedFile(); // Constructor: Maps nothing
+    ~MappedFile(); // Destructor: Unmaps the file
+    MappedFile(const MappedFile&) = delete; // Owns the mapping
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps a whole file, replacing any mapped one; returns false if it cannot be opened or mapped
+    bool Open(const char* path);
+
+    // Unmaps the file
+    void Close();
+
+    const unsigned char* GetData() const { return data; } // The file's bytes (nullptr when empty)
+    size_t GetSize() const { return size; }
+
+private:
+    const unsigned char* data; // Start of the mapping
+    size_t size; // Length of the file
+#ifdef _WIN32
+    void* file; // File handle
+    void* mapping; // File mapping handle
+#endif
+};
@@ -0,0 +1,430 @@
+#include "movegen.h" // Includes the header file for the move generator
+#include <cstring> // Includes memset for clearing the bitsets
+
+// Rotation a state's cells are compared under, and the offset moving them onto it
+struct Symmetry
+{
+    int rotation; // Lowest rotation with the same cells
+    int rowShift; // Row offset added when switching to that rotation
+    int columnShift; // Column offset added when switching to that rotation
+};
+
+// Canonical rotation of every rotation state of every block
+struct SymmetryTable
+{
+    Symmetry entries[numBlockTypes + 1][4];
+};
+
+// Checks if a rotation's cells are another rotation's cells moved by an offset
+constexpr bool SameCells(const PieceRotation& a, const PieceRotation& b, int rowShift, int columnShift)
+{
+    for (int i = 0; i < 4; i++) // Every cell of a must be a cell of b moved by the offset
+    {
+        bool found = false;
+        for (int j = 0; j < 4; j++)
+        {
+            if (a.cells[i].row == b.cells[j].row + rowShift && a.cells[i].column == b.cells[j].column + columnShift)
+            {
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Maps every rotation to the lowest rotation covering the same cells (e.g. the SBlock's 2 to 0)
+constexpr SymmetryTable BuildSymmetries()
+{
+    SymmetryTable table{};
+    for (int id = 0; id <= numBlockTypes; id++) // Every block
+    {
+        const PieceShape& shape = pieceShapes[id];
+        for (int rotation = 0; rotation < shape.numRotations; rotation++) // Every rotation state
+        {
+            table.entries[id][rotation] = Symmetry{ rotation, 0, 0 }; // Unique unless found below
+            for (int other = 0; other < rotation; other++) // Earlier rotations
+            {
+                const PieceRotation& a = shape.rotations[rotation];
+                const PieceRotation& b = shape.rotations[other];
+                int rowShift = a.minRow - b.minRow; // Lines the bounding boxes up
+                int columnShift = a.minColumn - b.minColumn;
+                if (SameCells(a, b, rowShift, columnShift))
+                {
+                    table.entries[id][rotation] = Symmetry{ other, rowShift, columnShift };
+                    break;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+constexpr SymmetryTable symmetries = BuildSymmetries();
+
+// Packs a rotation, row offset and column offset into a state index
+static inline int EncodeState(int rotation, int row, int column)
+{
+    return (rotation * moveRows + row + moveRowBase) * moveColumns + column + wallWidth;
+}
+
+// Helpers for the visited bitset
+static inline bool IsSet(const uint64_t* bits, int state)
+{
+    return (bits[state >> 6] >> (state & 63)) & 1;
+}
+
+static inline void SetBit(uint64_t* bits, int state)
+{
+    bits[state >> 6] |= (uint64_t)1 << (state & 63);
+}
+
+// Constructor: Starts with no placements
+MoveGenerator::MoveGenerator()
+{
+    blockId = 0;
+    startState = 0;
+    count = 0;
+}
+
+// Marks, for every rotation and row offset, the column offsets the block fits at
+// Replaces a collision test per move with one pass over the board per search
+void MoveGenerator::BuildFitMasks(const Grid& grid)
+{
+    // The board's rows for every row a cell can be on, with the rows outside the grid solid
+    // and the bits past the right wall solid too, so the loops below need no bounds checks
+    uint32_t boardRows[moveRows + 4];
+    for (int rowIndex = 0; rowIndex < moveRows + 4; rowIndex++)
+    {
+        int row = rowIndex - moveRowBase;
+        boardRows[rowIndex] = row < 0 || row >= grid.GetNumRows() ? 0xFFFFFFFF : grid.rows[row] | 0xFFFF0000;
+    }
+    uint32_t emptyRow = grid.GetEmptyRow() | 0xFFFF0000; // A row with nothing but the walls
+
+    const PieceShape& shape = pieceShapes[blockId];
+    for (int rotation = 0; rotation < shape.numRotations; rotation++)
+    {
+        const Position* cells = shape.rotations[rotation].cells;
+        // OR the board under each cell, shifted back to the block's column 0
+        openMasks[rotation] = (RowMask)~(emptyRow >> cells[0].column | emptyRow >> cells[1].column | emptyRow >> cells[2].column | emptyRow >> cells[3].column);
+        RowMask* masks = fitMasks + rotation * moveRows;
+        for (int rowIndex = 0; rowIndex < moveRows; rowIndex++)
+        {
+            uint32_t blocked = boardRows[rowIndex + cells[0].row] >> cells[0].column
+                | boardRows[rowIndex + cells[1].row] >> cells[1].column
+                | boardRows[rowIndex + cells[2].row] >> cells[2].column
+                | boardRows[rowIndex + cells[3].row] >> cells[3].column;
+            masks[rowIndex] = (RowMask)~blocked;
+        }
+    }
+}
+
+// Checks if every rotation fits on a row exactly as on an empty board
+bool MoveGenerator::IsOpenRow(int row) const
+{
+    for (int rotation = 0; rotation < pieceShapes[blockId].numRotations; rotation++)
+    {
+        if (fitMasks[rotation * moveRows + row] != openMasks[rotation])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks the fit mask of a single state
+inline bool MoveGenerator::Fits(int state) const
+{
+    return (fitMasks[state / moveColumns] >> (state % moveColumns)) & 1;
+}
+
+// Searches from the block's position and returns the number of placements found
+int MoveGenerator::Generate(const Grid& grid, const Block& block)
+{
+    blockId = block.id;
+    count = 0;
+    int row = block.GetRowOffset();
+    int column = block.GetColumnOffset();
+    if (row < -moveRowBase || row + moveRowBase >= moveRows || column < -wallWidth || column + wallWidth >= moveColumns)
+    {
+        return 0; // Outside the searched states
+    }
+    BuildFitMasks(grid);
+    startState = EncodeState(block.GetRotationState(), row, column);
+    if (!Fits(startState))
+    {
+        return 0; // The block is already stuck
+    }
+    memset(reached, 0, sizeof(reached));
+    memset(frontier, 0, sizeof(frontier));
+    memset(locked, 0, sizeof(locked));
+    frontier[startState / moveColumns] = (RowMask)(1 << (startState % moveColumns));
+    reached[startState / moveColumns] = frontier[startState / moveColumns];
+    int startRow = startState / moveColumns % moveRows;
+
+    // Between the spawn and the stack, the rows are usually empty: there, moving sideways and then
+    // down reaches the same states in as many inputs as moving down and then sideways
+    // So the search skips the middle of the first run of such rows, and the states first reached on
+    // its top row reappear on its bottom row as many layers later as the run is high
+    openTop = startRow;
+    while (openTop < moveRows && !IsOpenRow(openTop))
+    {
+        openTop++;
+    }
+    openBottom = openTop;
+    while (openBottom + 1 < moveRows && IsOpenRow(openBottom + 1))
+    {
+        openBottom++;
+    }
+    int openDelay = openBottom - openTop; // Layers between the top and the bottom row of the run
+    if (openTop >= moveRows || openDelay < 2) // Nothing worth skipping
+    {
+        openTop = moveRows;
+        openBottom = moveRows;
+        openDelay = 0;
+    }
+    RowMask openLayers[moveRows][4]; // States first reached on the run's top row, by layer (modulo moveRows)
+    memset(openLayers, 0, sizeof(openLayers));
+    int lastOpenLayer = -1; // Last layer that reached new states on the run's top row
+    if (startRow == openTop)
+    {
+        openLayers[0][block.GetRotationState()] = frontier[startState / moveColumns];
+        lastOpenLayer = 0;
+    }
+
+    // Breadth-first, one layer of inputs at a time, on whole rows of column offsets:
+    // every state of a layer is first reached by a shortest sequence of inputs
+    // Gravity is left out: the inputs are applied faster than the block falls
+    int numRotations = pieceShapes[blockId].numRotations;
+    int firstRow = startRow; // Rows of the frontier
+    int lastRow = startRow;
+    int firstTopRow = startRow; // Rows holding the tops of the frontier's columns (the start, at first)
+    int lastTopRow = startRow;
+    RowMask next[4 * moveRows]; // The next layer, for the rows it can reach
+    for (int layer = 0; ; layer++)
+    {
+        if (lastTopRow >= 0) // Dropping from the layer costs one more input
+        {
+            AddLandings(firstTopRow, lastTopRow, layer + 1);
+        }
+
+        // States move down one row at most, so the next layer lies on the frontier's rows or one below,
+        // plus the run's bottom row while states of its top row are still on their way
+        int bottom = lastRow + 1 < moveRows ? lastRow + 1 : lastRow;
+        bool delayed = lastOpenLayer >= 0 && layer + 1 <= lastOpenLayer + openDelay;
+        if (delayed && bottom < openBottom)
+        {
+            bottom = openBottom;
+        }
+        int openLayer = (layer + 1) % moveRows;
+        int arrivingLayer = (layer + 1 - openDelay + moveRows) % moveRows;
+        for (int rotation = 0; rotation < numRotations; rotation++)
+        {
+            int turnedFrom = (rotation == 0 ? numRotations - 1 : rotation - 1) * moveRows; // Rotating in place, as Game::RotateBlock does (no kicks)
+            for (row = firstRow; row <= bottom; row++)
+            {
+                int index = rotation * moveRows + row;
+                if (row > openTop && row < openBottom) // Skip the middle of the run; its rows stay empty
+                {
+                    row = openBottom - 1;
+                    continue;
+                }
+                if (row == openBottom && openDelay > 0) // States of the top row arrive on the bottom row
+                {
+                    next[index] = layer + 1 >= openDelay ? openLayers[arrivingLayer][rotation] : 0;
+                    continue;
+                }
+                RowMask here = frontier[index];
+                RowMask from = (RowMask)(here << 1 | here >> 1); // INPUT_RIGHT and INPUT_LEFT
+                from |= frontier[turnedFrom + row]; // INPUT_ROTATE
+                if (row > 0)
+                {
+                    from |= frontier[index - 1]; // INPUT_DOWN, which leads to tucks under overhangs
+                }
+                next[index] = from & fitMasks[index] & ~reached[index];
+            }
+            // Remember what the run's top row reached, whether or not the frontier still covers it
+            openLayers[openLayer][rotation] = openTop >= firstRow && openTop <= bottom ? next[rotation * moveRows + openTop] : 0;
+            if (openLayers[openLayer][rotation] != 0)
+            {
+                lastOpenLayer = layer + 1;
+            }
+        }
+
+        int newFirstRow = moveRows; // Rows of the next layer
+        int newLastRow = -1;
+        firstTopRow = moveRows;
+        lastTopRow = -1;
+        for (int rotation = 0; rotation < numRotations; rotation++)
+        {
+            for (row = firstRow; row <= bottom; row++) // Also empties the frontier's rows the next layer does not reach
+            {
+                if (row > openTop && row < openBottom) // Skip the middle of the run
+                {
+                    row = openBottom - 1;
+                    continue;
+                }
+                int index = rotation * moveRows + row;
+                frontier[index] = next[index];
+                reached[index] |= next[index];
+                if (next[index] != 0)
+                {
+                    newFirstRow = row < newFirstRow ? row : newFirstRow;
+                    newLastRow = row > newLastRow ? row : newLastRow;
+                    // Some states are not under reached ones (the run's bottom row is always under its top row)
+                    if (row == 0 || (row != openBottom && (next[index] & ~reached[index - 1]) != 0))
+                    {
+                        firstTopRow = row < firstTopRow ? row : firstTopRow;
+                        lastTopRow = row > lastTopRow ? row : lastTopRow;
+                    }
+                }
+            }
+        }
+        if (newLastRow < 0) // Nothing new this layer
+        {
+            if (!(lastOpenLayer >= 0 && layer + 1 < lastOpenLayer + openDelay))
+            {
+                break; // Every reachable state was found
+            }
+            newFirstRow = openBottom; // Wait for the states still crossing the run
+            newLastRow = openBottom;
+        }
+        firstRow = newFirstRow;
+        lastRow = newLastRow;
+    }
+    return count;
+}
+
+// Records the placements reached by dropping the tops of the frontier's columns, found between two rows
+void MoveGenerator::AddLandings(int firstRow, int lastRow, int numInputs)
+{
+    int numRotations = pieceShapes[blockId].numRotations;
+    for (int rotation = 0; rotation < numRotations; rotation++)
+    {
+        const Symmetry& symmetry = symmetries.entries[blockId][rotation];
+        RowMask falling = 0; // Columns of blocks still falling through the current row
+        // The two lowest row offsets never fit, so the row below always exists
+        for (int row = firstRow; row < moveRows - 1; row++)
+        {
+            int index = rotation * moveRows + row;
+            // A state under one reached no later drops to the same place with no fewer inputs,
+            // so only the tops of the frontier's columns fall; in open air that is the first layers only
+            if (row != openBottom) // The run's bottom row is always under its top row
+            {
+                falling |= frontier[index] & (row > 0 ? ~reached[index - 1] : (RowMask)~0);
+            }
+            if (falling == 0)
+            {
+                if (row >= lastRow) // Nothing left to drop
+                {
+                    break;
+                }
+                continue;
+            }
+            RowMask landed = falling & ~fitMasks[index + 1]; // Blocks that cannot fall further lock here
+            if (landed == 0)
+            {
+                if (row == openTop && openBottom < moveRows) // Nothing lands inside the skipped run
+                {
+                    row = openBottom - 1;
+                }
+                continue;
+            }
+            falling &= ~landed;
+
+            // Placements with the same cells are keyed by the same canonical rotation
+            int lockedIndex = symmetry.rotation * moveRows + row + symmetry.rowShift;
+            RowMask canonical = (RowMask)(symmetry.columnShift >= 0 ? landed << symmetry.columnShift : landed >> -symmetry.columnShift);
+            RowMask fresh = canonical & ~locked[lockedIndex]; // Only the first, shortest, drop to a lock position counts
+            locked[lockedIndex] |= fresh;
+            while (fresh != 0)
+            {
+                int bit = CountBits((RowMask)((fresh & -fresh) - 1)); // Index of the lowest set bit
+                fresh &= (RowMask)(fresh - 1);
+                Placement& placement = placements[count++];
+                placement.rotation = rotation;
+                placement.row = row - moveRowBase;
+                placement.column = bit - symmetry.columnShift - wallWidth;
+                placement.numInputs = numInputs;
+            }
+        }
+    }
+}
+
+// Returns the state of the canonical rotation covering the same cells as the block dropped from a state
+int MoveGenerator::GetLockedState(int state) const
+{
+    while (Fits(state + moveColumns)) // Fall until the row below is blocked
+    {
+        state += moveColumns;
+    }
+    int rotation = state / (moveRows * moveColumns);
+    const Symmetry& symmetry = symmetries.entries[blockId][rotation];
+    return state + (symmetry.rotation - rotation) * moveRows * moveColumns + symmetry.rowShift * moveColumns + symmetry.columnShift;
+}
+
+// Returns the block locked at a placement, ready for Game::PlaceBlock
+Block MoveGenerator::GetPlacedBlock(int index) const
+{
+    const Placement& placement = placements[index];
+    return Block(blockId, placement.rotation, placement.row, placement.column);
+}
+
+// Writes up to capacity inputs of a placement of the last search and returns the sequence's full length
+int MoveGenerator::GetPath(int index, GameInput inputs[], int capacity)
+{
+    // Search again state by state, keeping the input each state was reached with;
+    // the first state whose drop locks on the placement is one of the shortest
+    const Placement& placement = placements[index];
+    int target = GetLockedState(EncodeState(placement.rotation, placement.row, placement.column));
+    int numRotations = pieceShapes[blockId].numRotations;
+    const int rotationStride = moveRows * moveColumns;
+    memset(visited, 0, sizeof(visited));
+    int head = 0;
+    int tail = 0;
+    SetBit(visited, startState);
+    parent[startState] = (unsigned short)startState;
+    queue[tail++] = (unsigned short)startState;
+    while (head < tail)
+    {
+        int state = queue[head++];
+        if (GetLockedState(state) == target) // Found where to drop from
+        {
+            int length = placement.numInputs;
+            if (length - 1 < capacity)
+            {
+                inputs[length - 1] = INPUT_DROP; // Every sequence ends by dropping the block
+            }
+            for (int i = length - 2; i >= 0; i--) // Follow the parents back to the start
+            {
+                if (i < capacity)
+                {
+                    inputs[i] = (GameInput)move[state];
+                }
+                state = parent[state];
+            }
+            return length;
+        }
+
+        // The same moves as Generate; the wall bits and the two lowest row offsets never fit,
+        // so the neighbours of a state that fits never wrap into another row or rotation
+        int rotation = state / rotationStride;
+        int neighbours[4] = { state - 1, state + 1, rotation + 1 == numRotations ? state - rotation * rotationStride : state + rotationStride, state + moveColumns };
+        GameInput moves[4] = { INPUT_LEFT, INPUT_RIGHT, INPUT_ROTATE, INPUT_DOWN };
+        for (int i = 0; i < 4; i++)
+        {
+            int next = neighbours[i];
+            if (!IsSet(visited, next) && Fits(next))
+            {
+                SetBit(visited, next);
+                parent[next] = (unsigned short)state;
+                move[next] = (unsigned char)moves[i];
+                queue[tail++] = (unsigned short)next;
+            }
+        }
+    }
+    return 0; // Not reachable from the start (the placement is not from the last search)
+}
@@ -0,0 +1,79 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <stdint.h> // Includes the fixed-width words of the visited bitset
+#include "game.h" // Includes the Grid, the Block and the GameInput values of the paths
+
+// The searched states: rotation x row offset x column offset
+// The column offsets of one rotation and row are the bits of one RowMask (bit = column offset + wallWidth)
+const int moveRowBase = 2; // Row offsets start at -2, above the IBlock's spawn row
+const int moveRows = Grid::numRows + 4; // Row offsets -2 to numRows + 1
+const int moveColumns = 16; // Column offsets -wallWidth to 12, one per bit of a RowMask
+static_assert(Grid::numCols + 2 * wallWidth <= moveColumns, "every column offset of the Grid must have a bit of a RowMask");
+const int maxMoveStates = 4 * moveRows * moveColumns; // Every state of every rotation
+
+// One place the block can lock into, and the length of the shortest input sequence reaching it
+struct Placement
+{
+    int rotation; // Rotation state of the block when it locks
+    int row; // Row offset of the block when it locks
+    int column; // Column offset of the block when it locks
+    int numInputs; // Length of the shortest input sequence, including the final INPUT_DROP
+};
+
+// Finds every distinct position the current block can lock into, including tucks and spins
+// The search runs over fixed arrays held by the generator, so reusing one never allocates
+class MoveGenerator
+{
+public:
+    MoveGenerator(); // Constructor: Starts with no placements
+    MoveGenerator(const MoveGenerator&) = delete; // Holds kilobytes of search state; share one instead
+    MoveGenerator& operator=(const MoveGenerator&) = delete;
+
+    // Searches from the block's position and returns the number of placements found
+    // Placements with the same cells (e.g. the SBlock's two flat rotations) are returned once
+    int Generate(const Grid& grid, const Block& block);
+
+    int GetCount() const { return count; } // Number of placements found by the last search
+    const Placement& GetPlacement(int index) const { return placements[index]; }
+
+    // Returns the block locked at a placement, ready for Game::PlaceBlock
+    Block GetPlacedBlock(int index) const;
+
+    // Writes up to capacity inputs of a placement of the last search and returns the sequence's full length
+    // Applying the inputs with Game::ApplyInput locks the block at the placement
+    // Rebuilding a path costs more than Generate, so it is meant for the placement that gets played
+    int GetPath(int index, GameInput inputs[], int capacity);
+
+private:
+    // Marks, for every rotation and row offset, the column offsets the block fits at
+    void BuildFitMasks(const Grid& grid);
+
+    // Checks if every rotation fits on a row exactly as on an empty board
+    bool IsOpenRow(int row) const;
+
+    // Records the placements reached by dropping the tops of the frontier's columns, found between two rows
+    void AddLandings(int firstRow, int lastRow, int numInputs);
+
+    // Returns the state of the canonical rotation covering the same cells as the block dropped from a state
+    int GetLockedState(int state) const;
+
+    // Checks the fit mask of a single state
+    bool Fits(int state) const;
+
+    int blockId; // Type of the searched block
+    int startState; // State the search started from
+    int count; // Number of placements found
+    RowMask fitMasks[4 * moveRows]; // Column offsets the block fits at, per rotation and row offset
+    RowMask openMasks[4]; // Column offsets each rotation fits at on a row with nothing but the walls
+    int openTop; // First and last row of the run of open rows the search skips (moveRows when none)
+    int openBottom;
+    RowMask reached[4 * moveRows]; // States reached so far, per rotation and row offset
+    RowMask frontier[4 * moveRows]; // States first reached by the last layer of the search
+    RowMask locked[4 * moveRows]; // Placements already returned, keyed by their canonical rotation
+    Placement placements[maxMoveStates]; // Placements found by the last search
+
+    // Scratch space of GetPath's state-by-state search
+    uint64_t visited[maxMoveStates / 64]; // States already reached
+    unsigned short queue[maxMoveStates]; // States waiting to be expanded, in order of distance
+    unsigned short parent[maxMoveStates]; // State each visited state was reached from
+    unsigned char move[maxMoveStates]; // Input each visited state was reached with
+};
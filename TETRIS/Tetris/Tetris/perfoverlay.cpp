@@ -0,0 +1,169 @@
+#include "perfoverlay.h" // Includes the header file for the performance overlay
+
+#ifdef TETRIS_PERF_OVERLAY
+
+#include "allocations.h" // Includes the allocation counter sampled every frame
+#include <raylib.h>      // Includes the keyboard and the drawing of the overlay
+
+PerfOverlay perfOverlay;
+
+// Names and colors of the phases, in PerfPhase order
+static const char* const phaseNames[numPerfPhases] = { "other", "input", "simulation", "draw grid", "draw ui", "present" };
+static const Color phaseColors[numPerfPhases] = { GRAY, SKYBLUE, YELLOW, GREEN, ORANGE, PURPLE };
+
+// Histogram bucket of a frame time
+static int BucketOf(float seconds)
+{
+    int bucket = static_cast<int>(seconds / perfBucketSeconds);
+    return bucket < perfHistogramBuckets ? bucket : perfHistogramBuckets - 1;
+}
+
+// Constructor: Starts hidden with an empty history
+PerfOverlay::PerfOverlay()
+{
+    visible = false;
+    isTiming = false;
+    numFrames = 0;
+    nextFrame = 0;
+    frameStart = phaseStart = Clock::now();
+    phase = PERF_OTHER;
+    for (double& seconds : phaseSeconds)
+    {
+        seconds = 0;
+    }
+    drawCalls = 0;
+    frameAllocations = GetAllocationCount();
+}
+
+// Closes the last frame's record and starts timing a new frame in the input phase; F3 toggles the overlay
+void PerfOverlay::BeginFrame()
+{
+    Clock::time_point now = Clock::now();
+    phaseSeconds[phase] += std::chrono::duration<double>(now - phaseStart).count(); // The last stretch of the frame
+    long long allocations = GetAllocationCount();
+
+    if (isTiming) // The first call only starts the clock: nothing before it was a frame
+    {
+        RecordFrame(now, allocations);
+    }
+    isTiming = true;
+    frameStart = phaseStart = now;
+    phase = PERF_INPUT;
+    drawCalls = 0;
+    frameAllocations = allocations;
+
+    if (IsKeyPressed(KEY_F3))
+    {
+        visible = !visible;
+    }
+}
+
+// Adds the frame ending now to the history
+void PerfOverlay::RecordFrame(Clock::time_point now, long long allocations)
+{
+    FrameRecord& record = history[nextFrame];
+    record.seconds = std::chrono::duration<float>(now - frameStart).count();
+    for (int i = 0; i < numPerfPhases; i++)
+    {
+        record.phaseSeconds[i] = static_cast<float>(phaseSeconds[i]);
+        phaseSeconds[i] = 0;
+    }
+    record.drawCalls = drawCalls;
+    record.allocations = static_cast<int>(allocations - frameAllocations);
+    nextFrame = (nextFrame + 1) % perfHistoryFrames;
+    numFrames = numFrames < perfHistoryFrames ? numFrames + 1 : numFrames;
+}
+
+// Charges the time since the last switch to the current phase and continues in the given one
+PerfPhase PerfOverlay::SwitchPhase(PerfPhase next)
+{
+    Clock::time_point now = Clock::now();
+    phaseSeconds[phase] += std::chrono::duration<double>(now - phaseStart).count();
+    phaseStart = now;
+    PerfPhase previous = phase;
+    phase = next;
+    return previous;
+}
+
+// Draws the overlay in the top-left corner if it is shown
+// Shows the last frame, the average and slowest frame over the history, the average time of each phase
+// and the histogram of the frame times; the last frame's numbers are the ones that show a single stutter
+void PerfOverlay::Draw() const
+{
+    if (!visible || numFrames == 0)
+    {
+        return;
+    }
+
+    // Sum the history
+    const FrameRecord& last = history[(nextFrame + perfHistoryFrames - 1) % perfHistoryFrames];
+    double totalSeconds = 0;
+    float maxSeconds = 0;
+    double totalPhases[numPerfPhases] = {};
+    int maxDrawCalls = 0;
+    int maxAllocations = 0;
+    int buckets[perfHistogramBuckets] = {};
+    for (int i = 0; i < numFrames; i++)
+    {
+        const FrameRecord& record = history[i];
+        totalSeconds += record.seconds;
+        maxSeconds = record.seconds > maxSeconds ? record.seconds : maxSeconds;
+        for (int p = 0; p < numPerfPhases; p++)
+        {
+            totalPhases[p] += record.phaseSeconds[p];
+        }
+        maxDrawCalls = record.drawCalls > maxDrawCalls ? record.drawCalls : maxDrawCalls;
+        maxAllocations = record.allocations > maxAllocations ? record.allocations : maxAllocations;
+        buckets[BucketOf(record.seconds)]++;
+    }
+
+    const int x = 4; // Top-left corner of the panel
+    const int y = 4;
+    const int width = 250;
+    const int height = 236;
+    DrawRectangle(x, y, width, height, Color{ 0, 0, 0, 200 });
+
+    // Frame times
+    DrawText(TextFormat("frame %5.2f ms  avg %5.2f  max %5.2f", last.seconds * 1000, totalSeconds / numFrames * 1000,
+        maxSeconds * 1000), x + 6, y + 6, 10, WHITE);
+
+    // One row per phase: last frame, average, and a bar of the average's share of the frame
+    for (int p = 0; p < numPerfPhases; p++)
+    {
+        int rowY = y + 24 + p * 14;
+        double average = totalPhases[p] / numFrames;
+        DrawText(TextFormat("%-10s %6.3f  avg %6.3f", phaseNames[p], last.phaseSeconds[p] * 1000, average * 1000),
+            x + 6, rowY, 10, phaseColors[p]);
+        int bar = totalSeconds > 0 ? static_cast<int>(50 * average / (totalSeconds / numFrames)) : 0;
+        DrawRectangle(x + width - 56, rowY + 1, bar, 8, phaseColors[p]);
+    }
+
+    // Counters
+    int countersY = y + 24 + numPerfPhases * 14 + 4;
+    DrawText(TextFormat("draw calls %5d  max %5d", last.drawCalls, maxDrawCalls), x + 6, countersY, 10, WHITE);
+    DrawText(TextFormat("allocations %4d  max %5d", last.allocations, maxAllocations), x + 6, countersY + 14, 10,
+        last.allocations > 0 ? RED : WHITE);
+
+    // Histogram of the frame times, one bar per bucket, scaled to the fullest bucket
+    int histogramY = countersY + 34;
+    const int histogramHeight = 70;
+    const int barWidth = (width - 12) / perfHistogramBuckets;
+    int fullest = 1;
+    for (int count : buckets)
+    {
+        fullest = count > fullest ? count : fullest;
+    }
+    DrawRectangle(x + 6, histogramY + histogramHeight, barWidth * perfHistogramBuckets, 1, GRAY);
+    for (int b = 0; b < perfHistogramBuckets; b++)
+    {
+        int barHeight = buckets[b] * histogramHeight / fullest;
+        DrawRectangle(x + 6 + b * barWidth, histogramY + histogramHeight - barHeight, barWidth - 1, barHeight,
+            b == BucketOf(last.seconds) ? YELLOW : SKYBLUE); // The last frame's bucket stands out
+    }
+    DrawText("0", x + 6, histogramY + histogramHeight + 4, 10, GRAY);
+    DrawText(TextFormat("%d+ ms", static_cast<int>((perfHistogramBuckets - 1) * perfBucketSeconds * 1000)),
+        x + width - 46, histogramY + histogramHeight + 4, 10, GRAY);
+    DrawText(TextFormat("last %d frames", numFrames), x + width / 2 - 30, histogramY + histogramHeight + 4, 10, GRAY);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+// Parts of a frame the overlay times separately; every moment of a frame is charged to exactly one of them
+enum PerfPhase
+{
+    PERF_OTHER,      // Anything not inside another phase (asset uploads, audio, the state machine's bookkeeping)
+    PERF_INPUT,      // Reading the keyboard and applying the player's inputs
+    PERF_SIMULATION, // Gravity steps, the bot's inputs and replay events: moving and locking blocks
+    PERF_DRAW_GRID,  // GameView::Draw: the grid texture, the ghost, current and queued blocks
+    PERF_DRAW_UI,    // The screens' layers, labels and text, and the overlay itself
+    PERF_PRESENT,    // EndDrawing: submitting the frame, swapping buffers and waiting for the target frame rate
+    numPerfPhases
+};
+
+#ifdef TETRIS_PERF_OVERLAY
+
+#include <chrono> // Includes the high-resolution clock the phases are timed with
+
+const int perfHistoryFrames = 240; // Frames the histogram and the averages cover
+const int perfHistogramBuckets = 16; // Frame time buckets of the histogram
+const double perfBucketSeconds = 0.002; // Width of a bucket; the last one also holds every slower frame
+
+// Live frame timings, shown over the game when toggled with F3
+// The main loop starts each frame with BeginFrame and switches phases as it goes; functions called from it time
+// themselves with a PerfScope, which hands the time back to the caller's phase when it ends
+// Draw calls are counted where the game issues them, allocations through GetAllocationCount
+class PerfOverlay
+{
+public:
+    PerfOverlay(); // Constructor: Starts hidden with an empty history
+
+    // Closes the last frame's record and starts timing a new frame in the input phase; F3 toggles the overlay
+    void BeginFrame();
+
+    // Charges the time since the last switch to the current phase and continues in the given one
+    // Returns the phase that was running, so a scope can restore it
+    PerfPhase SwitchPhase(PerfPhase phase);
+
+    // Counts raylib draw calls issued this frame (shapes, text and textures, before raylib batches them)
+    void CountDrawCalls(int count) { drawCalls += count; }
+
+    // Draws the overlay in the top-left corner if it is shown
+    void Draw() const;
+
+private:
+    // What one frame cost
+    struct FrameRecord
+    {
+        float seconds; // From the start of the frame to the start of the next one
+        float phaseSeconds[numPerfPhases];
+        int drawCalls;
+        int allocations;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    // Adds the frame ending now to the history
+    void RecordFrame(Clock::time_point now, long long allocations);
+
+    bool visible; // The overlay is drawn
+    bool isTiming; // A frame has been started
+    FrameRecord history[perfHistoryFrames]; // Ring of the last frames
+    int numFrames; // Frames recorded so far, up to perfHistoryFrames
+    int nextFrame; // Ring slot the next record goes to
+    Clock::time_point frameStart; // Start of the frame being timed
+    Clock::time_point phaseStart; // Start of the current phase's stretch
+    PerfPhase phase; // Phase being timed
+    double phaseSeconds[numPerfPhases]; // Time charged to each phase this frame
+    int drawCalls; // Draw calls counted this frame
+    long long frameAllocations; // Allocation count at the start of the frame
+};
+
+// The main loop's overlay
+extern PerfOverlay perfOverlay;
+
+// Times the rest of a scope as one phase, then returns to the phase that was running
+// Nests: the time of an inner scope is charged to the inner phase only
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfPhase phase) : previous(perfOverlay.SwitchPhase(phase)) {}
+    ~PerfScope() { perfOverlay.SwitchPhase(previous); }
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    PerfPhase previous; // Phase to return to
+};
+
+#define PERF_BEGIN_FRAME() perfOverlay.BeginFrame()
+#define PERF_PHASE(phase) perfOverlay.SwitchPhase(phase)
+#define PERF_SCOPE(phase) PerfScope perfScope(phase)
+#define PERF_COUNT_DRAWS(count) perfOverlay.CountDrawCalls(count)
+#define PERF_DRAW_OVERLAY() perfOverlay.Draw()
+
+#else
+
+// Without TETRIS_PERF_OVERLAY the instrumentation compiles to nothing
+#define PERF_BEGIN_FRAME() ((void)0)
+#define PERF_PHASE(phase) ((void)0)
+#define PERF_SCOPE(phase) ((void)0)
+#define PERF_COUNT_DRAWS(count) ((void)0)
+#define PERF_DRAW_OVERLAY() ((void)0)
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+#include "bitboard.h" // Includes the RowMask type for the precomputed row masks
+#include "position.h" // Includes the Position class for defining cell positions
+
+// IDs of the seven Tetris blocks; 0 marks an empty cell
+// The IDs also index the cell colors (e.g., LBlock -> orange)
+enum BlockId
+{
+    EMPTY_CELL = 0,
+    L_BLOCK = 1,
+    J_BLOCK = 2,
+    I_BLOCK = 3,
+    O_BLOCK = 4,
+    S_BLOCK = 5,
+    T_BLOCK = 6,
+    Z_BLOCK = 7,
+    GARBAGE_CELL = 8 // Cells of the garbage rows sent in versus games; not a block
+};
+
+const int numBlockTypes = 7; // Number of different Tetris blocks
+
+// One rotation state of a block, relative to the block's offset on the grid
+struct PieceRotation
+{
+    Position cells[4]; // The four cells of the block
+    RowMask rowMasks[4]; // One mask per local row (bit = local column)
+    int minRow; // Bounding box of the cells
+    int maxRow;
+    int minColumn;
+    int maxColumn;
+    int bottoms[4]; // Lowest local row of the cells in each local column (-1 for a column without cells)
+};
+
+// Everything needed to place one block type on the grid
+struct PieceShape
+{
+    int numRotations; // Number of distinct rotation states (1 for the OBlock)
+    int spawnRow; // Initial vertical offset of the block
+    int spawnColumn; // Initial horizontal offset of the block
+    PieceRotation rotations[4]; // Cells, masks and bounds of each rotation state
+};
+
+// Builds a rotation state and precomputes its row masks, bounding box and column bottoms
+constexpr PieceRotation MakeRotation(Position a, Position b, Position c, Position d)
+{
+    PieceRotation rotation{ { a, b, c, d }, { 0, 0, 0, 0 }, 3, 0, 3, 0, { -1, -1, -1, -1 } };
+    for (int i = 0; i < 4; i++) // Iterates through each cell
+    {
+        Position cell = rotation.cells[i];
+        rotation.rowMasks[cell.row] |= (RowMask)(1 << cell.column); // Sets the cell's bit in its row
+        rotation.minRow = cell.row < rotation.minRow ? cell.row : rotation.minRow;
+        rotation.maxRow = cell.row > rotation.maxRow ? cell.row : rotation.maxRow;
+        rotation.minColumn = cell.column < rotation.minColumn ? cell.column : rotation.minColumn;
+        rotation.maxColumn = cell.column > rotation.maxColumn ? cell.column : rotation.maxColumn;
+        rotation.bottoms[cell.column] = cell.row > rotation.bottoms[cell.column] ? cell.row : rotation.bottoms[cell.column];
+    }
+    return rotation;
+}
+
+// All seven blocks and their rotation states, indexed by block ID and rotation
+constexpr PieceShape pieceShapes[numBlockTypes + 1] =
+{
+    // EMPTY_CELL: placeholder so the table can be indexed by block ID
+    { 1, 0, 0, { PieceRotation{} } },
+
+    // LBlock: Represents the "L" shaped Tetris block
+    { 4, 0, 3, {
+        MakeRotation(Position(0, 2), Position(1, 0), Position(1, 1), Position(1, 2)),
+        MakeRotation(Position(0, 1), Position(1, 1), Position(2, 1), Position(2, 2)),
+        MakeRotation(Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 0)),
+        MakeRotation(Position(0, 0), Position(0, 1), Position(1, 1), Position(2, 1)) } },
+
+    // JBlock: Represents the "J" shaped Tetris block
+    { 4, 0, 3, {
+        MakeRotation(Position(0, 0), Position(1, 0), Position(1, 1), Position(1, 2)),
+        MakeRotation(Position(0, 1), Position(0, 2), Position(1, 1), Position(2, 1)),
+        MakeRotation(Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 2)),
+        MakeRotation(Position(0, 1), Position(1, 1), Position(2, 0), Position(2, 1)) } },
+
+    // IBlock: Represents the "I" shaped Tetris block (spawns one row higher)
+    { 4, -1, 3, {
+        MakeRotation(Position(1, 0), Position(1, 1), Position(1, 2), Position(1, 3)),
+        MakeRotation(Position(0, 2), Position(1, 2), Position(2, 2), Position(3, 2)),
+        MakeRotation(Position(2, 0), Position(2, 1), Position(2, 2), Position(2, 3)),
+        MakeRotation(Position(0, 1), Position(1, 1), Position(2, 1), Position(3, 1)) } },
+
+    // OBlock: Represents the "O" (square) shaped Tetris block
+    { 1, 0, 4, {
+        MakeRotation(Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)) } },
+
+    // SBlock: Represents the "S" shaped Tetris block
+    { 4, 0, 3, {
+        MakeRotation(Position(0, 1), Position(0, 2), Position(1, 0), Position(1, 1)),
+        MakeRotation(Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 2)),
+        MakeRotation(Position(1, 1), Position(1, 2), Position(2, 0), Position(2, 1)),
+        MakeRotation(Position(0, 0), Position(1, 0), Position(1, 1), Position(2, 1)) } },
+
+    // TBlock: Represents the "T" shaped Tetris block
+    { 4, 0, 3, {
+        MakeRotation(Position(0, 1), Position(1, 0), Position(1, 1), Position(1, 2)),
+        MakeRotation(Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 1)),
+        MakeRotation(Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 1)),
+        MakeRotation(Position(0, 1), Position(1, 0), Position(1, 1), Position(2, 1)) } },
+
+    // ZBlock: Represents the "Z" shaped Tetris block
+    { 4, 0, 3, {
+        MakeRotation(Position(0, 0), Position(0, 1), Position(1, 1), Position(1, 2)),
+        MakeRotation(Position(0, 2), Position(1, 1), Position(1, 2), Position(2, 1)),
+        MakeRotation(Position(1, 0), Position(1, 1), Position(2, 1), Position(2, 2)),
+        MakeRotation(Position(0, 1), Position(1, 0), Position(1, 1), Position(2, 0)) } },
+};
@@ -0,0 +1,185 @@
+#include "planner.h" // Includes the header file for the beam planner
+#include <algorithm> // Includes sort and partial_sort for picking the beam
+#include <chrono>    // Includes the clock of the time budget
+#include "trace.h"   // Includes the mute of the hypothetical blocks' spans
+
+// Constructor: Starts the workers
+BeamPlanner::BeamPlanner(const PlannerSettings& settings)
+    : settings(settings), pool(settings.numWorkers)
+{
+    weights = defaultBotWeights;
+    workers.reset(new Worker[pool.GetNumWorkers()]);
+    beam.reserve(settings.beamWidth);
+    rootLines = 0;
+    timedLevel = false;
+    outOfTime = false;
+    lastDepth = 0;
+    lastNodes = 0;
+}
+
+// Finds the best placement of the current block and writes its inputs, ending with INPUT_DROP
+int BeamPlanner::Think(const Game& game, GameInput inputs[], int capacity)
+{
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(settings.budgetSeconds));
+    rootLines = game.linesCleared;
+    lastDepth = 0;
+    lastNodes = 0;
+    beam.clear();
+    beam.push_back(BeamNode{ game, 0.0, -1, 0 }); // The root; its children pick their own root placement
+
+    // Only the blocks the player can see are placed: the current one and the queue
+    int maxDepth = std::min(settings.maxDepth, 1 + game.GetQueueSize());
+    int bestRoot = 0; // Placement played if every line tops out
+    double levelSeconds = 0; // Time of the last level
+    size_t levelBeam = 1; // Boards the last level expanded
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        auto levelStart = std::chrono::steady_clock::now();
+        if (depth > 1 && settings.budgetSeconds > 0) // The first level always runs, so there is always a decision
+        {
+            double elapsed = std::chrono::duration<double>(levelStart - start).count();
+            double estimate = levelSeconds * beam.size() / levelBeam; // Levels cost about the same per board
+            if (elapsed + estimate > settings.budgetSeconds)
+            {
+                break;
+            }
+        }
+        levelBeam = beam.size();
+        // The first level always completes; a later one that runs out of time is dropped
+        if (!Expand(depth > 1 && settings.budgetSeconds > 0))
+        {
+            break;
+        }
+        if (!SelectBeam()) // Every line tops out: keep the last level's choice
+        {
+            break;
+        }
+        bestRoot = beam[0].root;
+        lastDepth = depth;
+        levelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - levelStart).count();
+    }
+
+    if (root.Generate(game.GetGrid(), game.GetCurrentBlock()) == 0) // Same placements, in the same order, as level 1
+    {
+        return 0;
+    }
+    return root.GetPath(bestRoot, inputs, capacity);
+}
+
+// Places the next block on every board of the beam and scores the children
+bool BeamPlanner::Expand(bool timed)
+{
+    timedLevel = timed;
+    outOfTime.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < pool.GetNumWorkers(); i++)
+    {
+        workers[i].children.clear(); // Keeps the capacity of earlier levels
+    }
+    // The lambda captures only this, so the std::function stores it without allocating
+    // The mute is per thread, so the caller's does not reach the pool's workers: each task mutes its own thread,
+    // or every hypothetical lock and clear would flood the trace
+    pool.ParallelFor((long long)beam.size(), 1, [this](long long index, int worker) {
+        TRACE_MUTE();
+        ExpandNode((int)index, worker);
+    });
+    return !outOfTime.load(std::memory_order_relaxed);
+}
+
+// Places the block on one board of the beam; runs on a pool worker
+void BeamPlanner::ExpandNode(int node, int worker)
+{
+    if (timedLevel) // Once one worker passes the deadline, the others skip their remaining boards
+    {
+        if (outOfTime.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() > deadline)
+        {
+            outOfTime.store(true, std::memory_order_relaxed);
+            return;
+        }
+    }
+    Worker& state = workers[worker];
+    const BeamNode& parent = beam[node];
+    int numPlacements = state.generator.Generate(parent.game.GetGrid(), parent.game.GetCurrentBlock());
+    state.batch.count = 0;
+    for (int i = 0; i < numPlacements; i++)
+    {
+        state.children.push_back(parent); // Games are plain values, so a child is a copy
+        BeamNode& child = state.children.back();
+        child.game.PlaceBlock(state.generator.GetPlacedBlock(i));
+        child.root = parent.root < 0 ? i : parent.root;
+        child.order = parent.order * maxMoveStates + i;
+        if (child.game.gameOver) // Topping out ends the line
+        {
+            state.children.pop_back();
+            continue;
+        }
+        state.batch.Add(child.game.GetGrid(), child.game.linesCleared - rootLines);
+        if (state.batch.count == boardBatchSize)
+        {
+            ScoreChildren(state);
+        }
+    }
+    if (state.batch.count > 0) // Score the children left over
+    {
+        ScoreChildren(state);
+    }
+}
+
+// Scores the children waiting in a worker's batch: the last batch.count children
+void BeamPlanner::ScoreChildren(Worker& state)
+{
+    EvaluateBatch(state.batch, state.features);
+    ScoreBatch(state.batch, state.features, weights, state.scores);
+    size_t first = state.children.size() - state.batch.count;
+    for (int i = 0; i < state.batch.count; i++)
+    {
+        state.children[first + i].score = state.scores[i];
+    }
+    state.batch.count = 0;
+}
+
+// Keeps the best beamWidth children of the level as the next beam, each board once; returns false if there are none
+bool BeamPlanner::SelectBeam()
+{
+    candidates.clear();
+    for (int w = 0; w < pool.GetNumWorkers(); w++)
+    {
+        for (size_t i = 0; i < workers[w].children.size(); i++)
+        {
+            const BeamNode& child = workers[w].children[i];
+            candidates.push_back(Candidate{ child.game.GetHash(), child.score, child.order, w, (int)i });
+        }
+    }
+    if (candidates.empty())
+    {
+        return false;
+    }
+    lastNodes += (long long)candidates.size();
+
+    // Different placement orders reach the same boards; keep each board once, from the line with the lowest order
+    // Done here, after the workers finished, so which copy survives never depends on which worker found it first
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.hash < b.hash || (a.hash == b.hash && a.order < b.order); });
+    size_t unique = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        if (unique == 0 || candidates[i].hash != candidates[unique - 1].hash)
+        {
+            candidates[unique++] = candidates[i];
+        }
+    }
+    candidates.resize(unique);
+
+    size_t keep = std::min(candidates.size(), (size_t)settings.beamWidth);
+    // Ties go to the lower order, so the beam doesn't depend on which worker expanded which board
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.score > b.score || (a.score == b.score && a.order < b.order); });
+    beam.clear();
+    for (size_t k = 0; k < keep; k++)
+    {
+        beam.push_back(workers[candidates[k].worker].children[candidates[k].index]);
+        beam.back().order = (int)k;
+    }
+    return true;
+}
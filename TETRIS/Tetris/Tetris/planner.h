@@ -0,0 +1,102 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <atomic>          // Includes the flag that stops a level running past the budget
+#include <chrono>          // Includes the deadline of a decision
+#include <memory>          // Includes unique_ptr for the per-worker state
+#include <vector>          // Includes the beam and the children of each level
+#include "evaluator.h"     // Includes the board features and their weights
+#include "movegen.h"       // Includes the move generator and the game rules
+#include "scheduler.h"     // Includes the work-stealing pool the levels are expanded on
+
+// Limits of a beam search
+struct PlannerSettings
+{
+    int beamWidth; // Boards kept from each level
+    int maxDepth; // Blocks placed along a line; capped by the blocks the queue shows
+    double budgetSeconds; // Time for one decision; 0 searches to maxDepth whatever it takes
+    int numWorkers; // Threads expanding each level, the caller included (0 = one per hardware thread)
+};
+
+// One millisecond per block, on every core
+const PlannerSettings defaultPlannerSettings = { 32, 6, 0.001, 0 };
+
+// Beam search over the current block and the queue: each level places the next block on every board of the beam,
+// scores the results with the board evaluator and keeps the best beamWidth of them
+// The boards of a level are expanded in parallel; a board reached by several lines is kept once, for the line
+// with the lowest order, so the beam and the decision are the same whatever the number of workers
+// The search goes one level deeper while the last level's time still fits in the budget;
+// a level that runs past it anyway is dropped half-way, so a decision overruns the budget by at most
+// one board's expansion, and always has at least one level
+// Its buffers grow to the size of a level once, so later decisions never allocate
+class BeamPlanner
+{
+public:
+    explicit BeamPlanner(const PlannerSettings& settings = defaultPlannerSettings); // Constructor: Starts the workers
+    BeamPlanner(const BeamPlanner&) = delete; // Owns threads
+    BeamPlanner& operator=(const BeamPlanner&) = delete;
+
+    // Finds the best placement of the current block and writes its inputs, ending with INPUT_DROP
+    // Returns the number of inputs, or 0 if the block cannot be placed anywhere
+    int Think(const Game& game, GameInput inputs[], int capacity);
+
+    int GetLastDepth() const { return lastDepth; } // Levels the last decision searched
+    long long GetLastNodes() const { return lastNodes; } // Boards the last decision scored
+    int GetNumWorkers() const { return pool.GetNumWorkers(); }
+
+    BotWeights weights; // Weights of the board features
+
+private:
+    // A board of the beam and the root placement that leads to it
+    struct BeamNode
+    {
+        Game game; // Position after the line's placements
+        double score; // Evaluation of the board
+        int root; // Placement of the current block the line starts with
+        int order; // Position of the node among its level's, for breaking ties the same way every time
+    };
+
+    // A child in the selection of the next beam
+    struct Candidate
+    {
+        uint64_t hash; // The child's position, for dropping boards reached twice
+        double score;
+        int order;
+        int worker; // Where the child is stored
+        int index;
+    };
+
+    // Everything one worker writes while expanding a level, kept on its own cache lines
+    struct alignas(cacheLineSize) Worker
+    {
+        MoveGenerator generator;
+        BoardBatch batch; // Children waiting to be scored
+        BoardFeatures features;
+        double scores[boardBatchSize];
+        std::vector<BeamNode> children; // Children of the level, scored
+    };
+
+    // Places the next block on every board of the beam and scores the children
+    // Returns false if the level ran out of time before every board was expanded
+    bool Expand(bool timed);
+
+    // Places the block on one board of the beam; runs on a pool worker
+    void ExpandNode(int node, int worker);
+
+    // Scores the children waiting in a worker's batch
+    void ScoreChildren(Worker& state);
+
+    // Keeps the best beamWidth children of the level as the next beam, each board once; returns false if there are none
+    bool SelectBeam();
+
+    PlannerSettings settings;
+    WorkStealingPool pool; // Threads expanding the levels
+    std::unique_ptr<Worker[]> workers; // One per pool worker
+    MoveGenerator root; // Placements of the current block
+    std::vector<BeamNode> beam; // Boards kept from the last level
+    std::vector<Candidate> candidates; // Children of the level being selected
+    int rootLines; // Rows cleared before the decision, so lines count from the root
+    std::chrono::steady_clock::time_point deadline; // End of the decision's budget
+    bool timedLevel; // The level being expanded stops at the deadline
+    std::atomic<bool> outOfTime; // Set by the first worker to pass the deadline
+    int lastDepth;
+    long long lastNodes;
+};
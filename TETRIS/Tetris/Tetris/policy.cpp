@@ -0,0 +1,145 @@
+#include "policy.h" // Includes the header file for the policies
+#include "bot.h" // Includes the move generator used by the greedy policy and the autoplay bot
+#include <cstdlib>  // Includes abs
+#include <cstring>  // Includes strcmp for looking policies up by name
+
+// Applies the inputs that rotate the current block turns times, shift it by shift columns and drop it
+void PlayPlacement(Game& game, int turns, int shift)
+{
+    for (int turn = 0; turn < turns; turn++) // Rotate first, while the block is near the top
+    {
+        game.ApplyInput(INPUT_ROTATE);
+    }
+    for (int step = 0; step < abs(shift); step++) // Then move it sideways
+    {
+        game.ApplyInput(shift < 0 ? INPUT_LEFT : INPUT_RIGHT);
+    }
+    game.ApplyInput(INPUT_DROP); // Drop and lock the block
+}
+
+// Advances a xorshift generator and returns the new value
+static unsigned int NextRandom(unsigned int& random)
+{
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random;
+}
+
+// Rotates and shifts the block by random amounts, then drops it
+void RandomPolicy(Game& game, unsigned int& random)
+{
+    unsigned int value = NextRandom(random);
+    PlayPlacement(game, value & 3, (int)((value >> 2) % 11) - 5); // Up to 3 turns and 5 columns either way
+}
+
+// Scores a board after a placement: rewards cleared rows, penalizes height and covered holes
+static int ScoreBoard(const Grid& grid, int linesCleared)
+{
+    RowMask playfield = (RowMask)~grid.GetEmptyRow(); // Bits of the playfield columns
+    int height = 0; // Height of the tallest column
+    int holes = 0; // Empty cells with a filled cell above them
+    RowMask seen = 0; // Columns that have a filled cell above the current row
+    for (int row = 0; row < grid.GetNumRows(); row++) // Scan from the top
+    {
+        RowMask cells = grid.rows[row] & playfield; // Filled cells of the row without the walls
+        if (seen == 0 && cells != 0) // First filled row from the top
+        {
+            height = grid.GetNumRows() - row;
+        }
+        holes += CountBits(seen & ~cells); // Empty cells under a filled one
+        seen |= cells;
+    }
+    return linesCleared * 100 - height * 5 - holes * 30;
+}
+
+// Tries every reachable placement on a copy of the game and plays the one leaving the best board
+void GreedyPolicy(Game& game, unsigned int& random)
+{
+    (void)random; // The greedy choice is deterministic
+    MoveGenerator generator; // Fixed arrays on the stack, so the policy stays allocation-free
+    int numPlacements = generator.Generate(game.GetGrid(), game.GetCurrentBlock());
+    if (numPlacements == 0) // Nothing fits; dropping ends the game
+    {
+        game.ApplyInput(INPUT_DROP);
+        return;
+    }
+    int bestScore = 0;
+    int best = 0;
+    for (int i = 0; i < numPlacements; i++) // Every placement the block can reach, tucks included
+    {
+        Game trial = game; // Games are plain values, so trying a placement is a copy
+        trial.PlaceBlock(generator.GetPlacedBlock(i));
+        int score = trial.gameOver ? -1000000 : ScoreBoard(trial.GetGrid(), trial.linesCleared - game.linesCleared);
+        if (i == 0 || score > bestScore) // Keep the best placement
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+    GameInput inputs[maxMoveStates]; // A path visits every state at most once
+    int numInputs = generator.GetPath(best, inputs, maxMoveStates);
+    for (int i = 0; i < numInputs; i++) // Play the inputs so the game counts them
+    {
+        game.ApplyInput(inputs[i]);
+    }
+}
+
+// Plays the placement the two-block Bot picks, looking one block ahead
+void BotPolicy(Game& game, unsigned int& random)
+{
+    (void)random; // The bot is deterministic
+    Bot bot; // Its generators are fixed arrays, so this stays allocation-free
+    GameInput inputs[maxMoveStates]; // A path visits every state at most once
+    int numInputs = bot.Think(game, inputs, maxMoveStates);
+    if (numInputs == 0) // Nothing fits; dropping ends the game
+    {
+        game.ApplyInput(INPUT_DROP);
+        return;
+    }
+    for (int i = 0; i < numInputs; i++)
+    {
+        game.ApplyInput(inputs[i]);
+    }
+}
+
+// Plays the placement a single-threaded beam search picks, four blocks deep with no time limit
+void BeamPolicy(Game& game, unsigned int& random)
+{
+    (void)random; // The search is deterministic on one thread
+    // One planner per thread, created on first use: it owns a table and buffers worth keeping between blocks
+    static thread_local BeamPlanner planner(PlannerSettings{ 16, 4, 0.0, 1 });
+    GameInput inputs[maxMoveStates]; // A path visits every state at most once
+    int numInputs = planner.Think(game, inputs, maxMoveStates);
+    if (numInputs == 0) // Nothing fits; dropping ends the game
+    {
+        game.ApplyInput(INPUT_DROP);
+        return;
+    }
+    for (int i = 0; i < numInputs; i++)
+    {
+        game.ApplyInput(inputs[i]);
+    }
+}
+
+// Returns the policy with the given name ("random", "greedy", "bot" or "beam"), or nullptr if there is none
+Policy FindPolicy(const char* name)
+{
+    if (strcmp(name, "random") == 0)
+    {
+        return RandomPolicy;
+    }
+    if (strcmp(name, "greedy") == 0)
+    {
+        return GreedyPolicy;
+    }
+    if (strcmp(name, "bot") == 0)
+    {
+        return BotPolicy;
+    }
+    if (strcmp(name, "beam") == 0)
+    {
+        return BeamPolicy;
+    }
+    return nullptr;
+}
@@ -0,0 +1,25 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include "game.h" // Includes the Game rules that policies play
+
+// A policy plays one block: it applies inputs to the current block and ends with INPUT_DROP
+// random is the policy's own generator state, so policies on different threads don't interfere
+typedef void (*Policy)(Game& game, unsigned int& random);
+
+// Rotates and shifts the block by random amounts, then drops it
+void RandomPolicy(Game& game, unsigned int& random);
+
+// Tries every rotation and column on a copy of the game and plays the one leaving the best board
+void GreedyPolicy(Game& game, unsigned int& random);
+
+// Plays the placement the two-block Bot picks, looking one block ahead
+void BotPolicy(Game& game, unsigned int& random);
+
+// Plays the placement a single-threaded beam search picks, four blocks deep with no time limit,
+// so runs are repeatable; each calling thread keeps its own planner
+void BeamPolicy(Game& game, unsigned int& random);
+
+// Returns the policy with the given name ("random", "greedy", "bot" or "beam"), or nullptr if there is none
+Policy FindPolicy(const char* name);
+
+// Applies the inputs that rotate the current block turns times, shift it by shift columns and drop it
+void PlayPlacement(Game& game, int turns, int shift);
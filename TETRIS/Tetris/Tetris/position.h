@@ -4,9 +4,13 @@
 class Position
 {
 public:
+    // Default constructor: Initializes the position to (0, 0)
+    constexpr Position() : row(0), column(0) {}
+
     // Constructor: Initializes a Position object with the given row and column
-    Position(int row, int column);
+    // constexpr so positions can be stored in the compile-time piece table
+    constexpr Position(int row, int column) : row(row), column(column) {}
 
     int row;    // The row index of the position on the grid
     int column; // The column index of the position on the grid
-};
\ No newline at end of file
+};
@@ -0,0 +1,135 @@
+#include "randomizer.h" // Includes the header file for the random generator, bag and queue
+
+// SplitMix64 step, used to expand a 64-bit seed into the generator state
+static uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Rotates a 32-bit value left
+static uint32_t RotateLeft(uint32_t value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// Constructor: Seeds the generator with 0
+Random::Random()
+{
+    Seed(0);
+}
+
+// Constructor: Seeds the generator
+Random::Random(uint64_t seed)
+{
+    Seed(seed);
+}
+
+// Restarts the sequence for the given seed
+void Random::Seed(uint64_t seed)
+{
+    uint64_t first = SplitMix64(seed); // SplitMix64 never yields an all-zero pair for xoshiro
+    uint64_t second = SplitMix64(seed);
+    state[0] = (uint32_t)first;
+    state[1] = (uint32_t)(first >> 32);
+    state[2] = (uint32_t)second;
+    state[3] = (uint32_t)(second >> 32);
+}
+
+// Returns the next 32 random bits
+uint32_t Random::Next()
+{
+    uint32_t result = RotateLeft(state[1] * 5, 7) * 9; // xoshiro128** output
+    uint32_t shifted = state[1] << 9;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = RotateLeft(state[3], 11);
+    return result;
+}
+
+// Returns an unbiased value in [0, bound) (Lemire's multiply-and-reject)
+int Random::NextBelow(int bound)
+{
+    uint64_t product = (uint64_t)Next() * (uint32_t)bound;
+    uint32_t low = (uint32_t)product;
+    if (low < (uint32_t)bound) // Possibly in the biased zone
+    {
+        uint32_t threshold = (0u - (uint32_t)bound) % (uint32_t)bound;
+        while (low < threshold) // Reject and redraw
+        {
+            product = (uint64_t)Next() * (uint32_t)bound;
+            low = (uint32_t)product;
+        }
+    }
+    return (int)(product >> 32);
+}
+
+// Constructor: Seeds the bag with 0
+BlockBag::BlockBag()
+{
+    Seed(0);
+}
+
+// Restarts the block sequence for the given seed
+void BlockBag::Seed(uint64_t seed)
+{
+    random.Seed(seed);
+    remaining = 0; // The first Next call shuffles a fresh bag
+}
+
+// Returns the ID of the next block
+int BlockBag::Next()
+{
+    if (remaining == 0) // The bag is empty: put every block back and shuffle
+    {
+        for (int i = 0; i < numBlockTypes; i++)
+        {
+            bag[i] = (unsigned char)(i + 1); // Block IDs start at 1
+        }
+        for (int i = numBlockTypes - 1; i > 0; i--) // Fisher-Yates shuffle
+        {
+            int j = random.NextBelow(i + 1);
+            unsigned char swapped = bag[i];
+            bag[i] = bag[j];
+            bag[j] = swapped;
+        }
+        remaining = numBlockTypes;
+    }
+    return bag[--remaining];
+}
+
+// Constructor: Creates an empty queue
+PieceQueue::PieceQueue()
+{
+    for (int i = 0; i < queueCapacity; i++)
+    {
+        ids[i] = EMPTY_CELL;
+    }
+    head = 0;
+    size = 0;
+}
+
+// Tops the queue up to queueCapacity blocks
+void PieceQueue::Fill(BlockBag& bag)
+{
+    while (size < queueCapacity)
+    {
+        ids[(head + size) % queueCapacity] = (unsigned char)bag.Next();
+        size++;
+    }
+}
+
+// Removes and returns the next block, refilling the freed slot
+int PieceQueue::Pop(BlockBag& bag)
+{
+    int id = ids[head];
+    head = (head + 1) % queueCapacity;
+    size--;
+    Fill(bag); // Keep the lookahead full
+    return id;
+}
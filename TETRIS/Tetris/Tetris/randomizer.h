@@ -0,0 +1,54 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+#include <cstdint> // Includes the fixed-width integer types of the generator state
+#include "pieces.h" // Includes the block IDs and numBlockTypes
+
+// Small, fast pseudo-random generator (xoshiro128**) seeded through SplitMix64
+// Uses only fixed-width integer arithmetic, so a seed gives the same numbers on every platform and compiler
+class Random
+{
+public:
+    Random(); // Constructor: Seeds the generator with 0
+    explicit Random(uint64_t seed); // Constructor: Seeds the generator
+
+    void Seed(uint64_t seed); // Restarts the sequence for the given seed
+    uint32_t Next(); // Returns the next 32 random bits
+    int NextBelow(int bound); // Returns an unbiased value in [0, bound)
+
+private:
+    uint32_t state[4]; // Generator state (never all zero)
+};
+
+// The "7-bag" block generator: deals the seven blocks in a shuffled order, then reshuffles
+class BlockBag
+{
+public:
+    BlockBag(); // Constructor: Seeds the bag with 0
+    void Seed(uint64_t seed); // Restarts the block sequence for the given seed
+    int Next(); // Returns the ID of the next block
+
+private:
+    Random random; // Generator used for the shuffles
+    unsigned char bag[numBlockTypes]; // Shuffled IDs of the current bag
+    int remaining; // Number of IDs of the current bag not dealt yet
+};
+
+// Number of upcoming blocks kept ahead of the current one
+const int queueCapacity = 8;
+
+// Fixed-capacity ring buffer of the upcoming block IDs, kept full from a BlockBag
+class PieceQueue
+{
+public:
+    PieceQueue(); // Constructor: Creates an empty queue
+    void Fill(BlockBag& bag); // Tops the queue up to queueCapacity blocks
+    int Pop(BlockBag& bag); // Removes and returns the next block, refilling the freed slot
+    int Peek(int index) const { return ids[(head + index) % queueCapacity]; } // index 0 is the next block
+    void Replace(int index, int id) { ids[(head + index) % queueCapacity] = (unsigned char)id; } // Swaps a block in
+    int GetSize() const { return size; } // Number of blocks in the queue
+
+private:
+    unsigned char ids[queueCapacity]; // Block IDs, starting at head
+    int head; // Slot of the next block
+    int size; // Number of blocks in the queue
+};
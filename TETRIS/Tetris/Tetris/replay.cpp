@@ -0,0 +1,254 @@
+#include "replay.h" // Includes the header file for the replay recorder and reader
+#include <cmath>    // Includes floor for the timestamps
+#include <cstdio>   // Includes the file writing
+#include <cstring>  // Includes memcmp for the magic bytes
+
+static const unsigned char replayMagic[4] = { 'T', 'R', 'P', 'L' }; // First bytes of every replay
+
+// Takes the summary of a game
+ReplaySummary SummarizeGame(const Game& game)
+{
+    ReplaySummary summary;
+    summary.score = game.score;
+    summary.linesCleared = game.linesCleared;
+    summary.blocksPlaced = game.blocksPlaced;
+    summary.inputCount = game.inputCount;
+    summary.gameOver = game.gameOver;
+    summary.hash = game.GetHash();
+    return summary;
+}
+
+// Checks that two summaries are identical in every field
+bool SummariesMatch(const ReplaySummary& a, const ReplaySummary& b)
+{
+    return a.score == b.score && a.linesCleared == b.linesCleared && a.blocksPlaced == b.blocksPlaced
+        && a.inputCount == b.inputCount && a.gameOver == b.gameOver && a.hash == b.hash;
+}
+
+// Constructor: Starts idle
+ReplayRecorder::ReplayRecorder()
+{
+    startTime = 0;
+    lastMs = 0;
+    recording = false;
+}
+
+// Starts a game dealt by Game::Reset(seed)
+void ReplayRecorder::Start(uint64_t seed, double now)
+{
+    bytes.clear(); // Keeps the capacity of earlier games
+    for (unsigned char magic : replayMagic)
+    {
+        bytes.push_back(magic);
+    }
+    bytes.push_back((unsigned char)replayVersion);
+    WriteVarint(seed);
+    startTime = now;
+    lastMs = 0;
+    recording = true;
+}
+
+// Records an input applied with Game::ApplyInput
+void ReplayRecorder::RecordInput(GameInput input, double now)
+{
+    Record((int)input, now);
+}
+
+// Records a gravity tick (Game::MoveBlockDown)
+void ReplayRecorder::RecordGravity(double now)
+{
+    Record(REPLAY_GRAVITY, now);
+}
+
+// Appends one event: the time since the last event and the kind in one varint
+void ReplayRecorder::Record(int kind, double now)
+{
+    if (!recording)
+    {
+        return;
+    }
+    double elapsed = (now - startTime) * 1000.0;
+    uint32_t timeMs = elapsed > 0 ? (uint32_t)floor(elapsed) : 0;
+    timeMs = timeMs > lastMs ? timeMs : lastMs; // Events stay in order even if the caller's clock steps back
+    WriteVarint((uint64_t)(timeMs - lastMs) << 3 | (uint64_t)kind);
+    lastMs = timeMs;
+}
+
+// Ends the events and stores the game's final state
+void ReplayRecorder::Finish(const Game& game)
+{
+    if (!recording)
+    {
+        return;
+    }
+    WriteVarint(REPLAY_END);
+    ReplaySummary summary = SummarizeGame(game);
+    WriteVarint((uint64_t)summary.score);
+    WriteVarint((uint64_t)summary.linesCleared);
+    WriteVarint((uint64_t)summary.blocksPlaced);
+    WriteVarint((uint64_t)summary.inputCount);
+    WriteVarint(summary.gameOver ? 1 : 0);
+    for (int i = 0; i < 8; i++) // The hash has no small values to gain from a varint
+    {
+        bytes.push_back((unsigned char)(summary.hash >> (8 * i)));
+    }
+    recording = false;
+}
+
+// Writes the replay to a file
+bool ReplayRecorder::Save(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && written;
+}
+
+// Appends a LEB128 varint
+void ReplayRecorder::WriteVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back((unsigned char)(value | 0x80)); // Low 7 bits, more to come
+        value >>= 7;
+    }
+    bytes.push_back((unsigned char)value);
+}
+
+// Constructor: Checks the header
+ReplayReader::ReplayReader(const unsigned char* data, size_t size)
+{
+    this->data = data;
+    this->size = size;
+    position = 0;
+    seed = 0;
+    timeMs = 0;
+    ended = false;
+    valid = size >= 5 && memcmp(data, replayMagic, 4) == 0 && data[4] == replayVersion;
+    if (valid)
+    {
+        position = 5;
+        valid = ReadVarint(seed);
+    }
+}
+
+// Reads the next event; returns false at the end marker or if the data is corrupt
+bool ReplayReader::Next(ReplayEvent& event)
+{
+    uint64_t value = 0;
+    if (!valid || ended || !ReadVarint(value))
+    {
+        return false;
+    }
+    int kind = (int)(value & 7);
+    if (kind == REPLAY_END)
+    {
+        ended = true;
+        return false;
+    }
+    if (kind > REPLAY_GRAVITY || (value >> 3) > 0xFFFFFFFFu - timeMs) // Unknown kind or time past 49 days
+    {
+        valid = false;
+        return false;
+    }
+    timeMs += (uint32_t)(value >> 3);
+    event.kind = kind;
+    event.timeMs = timeMs;
+    return true;
+}
+
+// Reads the final state once Next returned false
+bool ReplayReader::ReadSummary(ReplaySummary& summary)
+{
+    uint64_t fields[5];
+    if (!valid || !ended)
+    {
+        return false;
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        if (!ReadVarint(fields[i]) || fields[i] > 0x7FFFFFFF)
+        {
+            valid = false;
+            return false;
+        }
+    }
+    if (size - position < 8)
+    {
+        valid = false;
+        return false;
+    }
+    summary.score = (int)fields[0];
+    summary.linesCleared = (int)fields[1];
+    summary.blocksPlaced = (int)fields[2];
+    summary.inputCount = (int)fields[3];
+    summary.gameOver = fields[4] != 0;
+    summary.hash = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        summary.hash |= (uint64_t)data[position++] << (8 * i);
+    }
+    return true;
+}
+
+// Reads a LEB128 varint; false past the end or on one longer than 64 bits
+bool ReplayReader::ReadVarint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (position >= size) // Truncated
+        {
+            valid = false;
+            return false;
+        }
+        unsigned char byte = data[position++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    valid = false; // Overlong
+    return false;
+}
+
+// Applies a replay event to a game
+void ApplyReplayEvent(Game& game, const ReplayEvent& event)
+{
+    if (event.kind == REPLAY_GRAVITY)
+    {
+        game.MoveBlockDown();
+    }
+    else
+    {
+        game.ApplyInput((GameInput)event.kind);
+    }
+}
+
+// Re-simulates a whole replay as fast as possible and checks the final state
+ReplayResult SimulateReplay(const unsigned char* data, size_t size, Game& game, long long& numEvents)
+{
+    numEvents = 0;
+    ReplayReader reader(data, size);
+    if (!reader.IsValid())
+    {
+        return REPLAY_CORRUPT;
+    }
+    game.Reset(reader.GetSeed());
+    ReplayEvent event;
+    while (reader.Next(event))
+    {
+        ApplyReplayEvent(game, event);
+        numEvents++;
+    }
+    ReplaySummary recorded;
+    if (!reader.ReadSummary(recorded))
+    {
+        return REPLAY_CORRUPT;
+    }
+    return SummariesMatch(SummarizeGame(game), recorded) ? REPLAY_OK : REPLAY_MISMATCH;
+}
@@ -0,0 +1,112 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <cstddef> // Includes size_t for the replay buffers
+#include <cstdint> // Includes the fixed-width seed, timestamps and hash
+#include <vector>  // Includes the recorder's growing byte buffer
+#include "game.h"  // Includes the Game rules the replays drive
+
+// Replay file: everything needed to play a game again exactly
+//   "TRPL", a version byte, the seed as a varint,
+//   one varint per event: (milliseconds since the previous event << 3) | kind,
+//   the end marker (kind 7), then the final state (score, lines, blocks, inputs, game over as varints,
+//   and the game's hash as 8 little-endian bytes) that playback checks bit for bit
+// Most events take one byte: a key press or a gravity tick rarely comes more than 15 ms after the last event
+// Varints are LEB128: 7 bits per byte, low bits first, high bit set on every byte but the last
+
+const int replayVersion = 1; // Bumped whenever the rules or the format change what a replay means
+
+// Kinds of replay events; the GameInput values are stored as themselves
+enum ReplayEventKind
+{
+    REPLAY_GRAVITY = 5, // A gravity tick: Game::MoveBlockDown, which unlike INPUT_DOWN is not a player input
+    REPLAY_END = 7      // End of the events
+};
+
+// One event read from a replay
+struct ReplayEvent
+{
+    int kind; // A GameInput or REPLAY_GRAVITY
+    uint32_t timeMs; // Milliseconds since the game started
+};
+
+// Final state of a game, stored at the end of its replay
+struct ReplaySummary
+{
+    int score;
+    int linesCleared;
+    int blocksPlaced;
+    int inputCount;
+    bool gameOver;
+    uint64_t hash; // Game::GetHash of the final position
+};
+
+// Takes the summary of a game
+ReplaySummary SummarizeGame(const Game& game);
+
+// Checks that two summaries are identical in every field
+bool SummariesMatch(const ReplaySummary& a, const ReplaySummary& b);
+
+// Records one game; the buffer is reused from game to game, so recording stops allocating once it is big enough
+class ReplayRecorder
+{
+public:
+    ReplayRecorder(); // Constructor: Starts idle
+
+    void Start(uint64_t seed, double now); // Starts a game dealt by Game::Reset(seed); now is the caller's clock in seconds
+    void RecordInput(GameInput input, double now); // Records an input applied with Game::ApplyInput
+    void RecordGravity(double now); // Records a gravity tick (Game::MoveBlockDown)
+    void Finish(const Game& game); // Ends the events and stores the game's final state
+
+    bool IsRecording() const { return recording; } // Started and not finished yet
+    const std::vector<unsigned char>& GetBytes() const { return bytes; } // The replay, complete after Finish
+    bool Save(const char* path) const; // Writes the replay to a file; returns false on failure
+
+private:
+    void Record(int kind, double now); // Appends one event
+    void WriteVarint(uint64_t value); // Appends a LEB128 varint
+
+    std::vector<unsigned char> bytes; // The replay so far
+    double startTime; // Caller's clock when the game started
+    uint32_t lastMs; // Time of the last event
+    bool recording;
+};
+
+// Reads a replay held in memory (a buffer or a mapped file) without copying it
+class ReplayReader
+{
+public:
+    ReplayReader(const unsigned char* data, size_t size); // Constructor: Checks the header
+
+    bool IsValid() const { return valid; } // The header was read and no read ran past the end
+    uint64_t GetSeed() const { return seed; }
+
+    // Reads the next event; returns false at the end marker or if the data is corrupt
+    bool Next(ReplayEvent& event);
+
+    // Reads the final state once Next returned false; returns false if the replay is corrupt or truncated
+    bool ReadSummary(ReplaySummary& summary);
+
+private:
+    bool ReadVarint(uint64_t& value); // Reads a LEB128 varint; false past the end or on an overlong one
+
+    const unsigned char* data;
+    size_t size;
+    size_t position; // Next byte to read
+    uint64_t seed;
+    uint32_t timeMs; // Time of the last event read
+    bool valid;
+    bool ended; // The end marker was read
+};
+
+// Applies a replay event to a game: inputs through ApplyInput, gravity ticks through MoveBlockDown
+void ApplyReplayEvent(Game& game, const ReplayEvent& event);
+
+// Outcome of re-simulating a replay
+enum ReplayResult
+{
+    REPLAY_OK,       // The game ended exactly as recorded
+    REPLAY_CORRUPT,  // The file is not a complete replay of this version
+    REPLAY_MISMATCH  // The game ended differently: the rules changed or the replay was edited
+};
+
+// Re-simulates a whole replay as fast as possible and checks the final state; numEvents gets the events applied
+ReplayResult SimulateReplay(const unsigned char* data, size_t size, Game& game, long long& numEvents);
@@ -0,0 +1,180 @@
+#include "scheduler.h" // Includes the header file for the WorkStealingPool class
+#include <algorithm>   // Includes std::min
+
+// Packs a range into the 64-bit value stored in a WorkerRange
+static uint64_t PackRange(long long begin, long long end)
+{
+    return ((uint64_t)end << 32) | (uint64_t)begin;
+}
+
+// Constructor: Starts the workers (0 = one per hardware thread)
+WorkStealingPool::WorkStealingPool(int numWorkers)
+{
+    if (numWorkers <= 0) // Use every core by default
+    {
+        numWorkers = (int)std::thread::hardware_concurrency();
+    }
+    this->numWorkers = numWorkers > 0 ? numWorkers : 1;
+    ranges.reset(new WorkerRange[this->numWorkers]);
+    for (int worker = 0; worker < this->numWorkers; worker++)
+    {
+        ranges[worker].range.store(0); // Empty range
+    }
+    task = nullptr;
+    grain = 1;
+    generation = 0;
+    busyWorkers = 0;
+    stopping = false;
+    for (int worker = 1; worker < this->numWorkers; worker++) // Worker 0 is the calling thread
+    {
+        threads.emplace_back(&WorkStealingPool::WorkerLoop, this, worker);
+    }
+}
+
+// Destructor: Stops and joins the workers
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true; // Ask every worker to exit
+    }
+    jobReady.notify_all();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// Calls task(index, worker) for every index in [0, count) and returns when all calls finished
+void WorkStealingPool::ParallelFor(long long count, long long grain, const std::function<void(long long, int)>& task)
+{
+    if (count <= 0) // Nothing to do
+    {
+        return;
+    }
+    // Give every worker an even share of the indices to start with
+    for (int worker = 0; worker < numWorkers; worker++)
+    {
+        long long begin = count * worker / numWorkers;
+        long long end = count * (worker + 1) / numWorkers;
+        ranges[worker].range.store(PackRange(begin, end), std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->grain = grain > 0 ? grain : 1;
+        busyWorkers = numWorkers - 1;
+        generation++; // Publishes the ranges and the task to the workers
+    }
+    jobReady.notify_all();
+
+    RunWorker(0); // The calling thread works too
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this] { return busyWorkers == 0; }); // Wait for the background workers
+    this->task = nullptr;
+}
+
+// Background thread body: waits for jobs and runs them
+void WorkStealingPool::WorkerLoop(int worker)
+{
+    int seenGeneration = 0; // Last job this worker ran
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) // The pool is shutting down
+            {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        RunWorker(worker); // Run chunks until every range is empty
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--; // This worker is done with the job
+        }
+        jobDone.notify_one();
+    }
+}
+
+// Runs chunks until no worker has work left
+void WorkStealingPool::RunWorker(int worker)
+{
+    long long begin = 0;
+    long long end = 0;
+    while (TakeChunk(worker, begin, end))
+    {
+        for (long long index = begin; index < end; index++)
+        {
+            (*task)(index, worker);
+        }
+    }
+}
+
+// Takes the next chunk from the worker's own range, stealing half of another worker's range when it is empty
+bool WorkStealingPool::TakeChunk(int worker, long long& begin, long long& end)
+{
+    std::atomic<uint64_t>& own = ranges[worker].range;
+    while (true)
+    {
+        // Take a chunk from the front of the worker's own range
+        uint64_t packed = own.load(std::memory_order_acquire);
+        long long ownBegin = (long long)(packed & 0xFFFFFFFFu);
+        long long ownEnd = (long long)(packed >> 32);
+        if (ownBegin < ownEnd)
+        {
+            long long chunkEnd = std::min(ownBegin + grain, ownEnd);
+            if (own.compare_exchange_weak(packed, PackRange(chunkEnd, ownEnd), std::memory_order_acq_rel))
+            {
+                begin = ownBegin;
+                end = chunkEnd;
+                return true;
+            }
+            continue; // A thief changed the range; try again
+        }
+
+        // The own range is empty: steal the upper half of another worker's range
+        bool stole = false;
+        for (int offset = 1; offset < numWorkers && !stole; offset++)
+        {
+            std::atomic<uint64_t>& victim = ranges[(worker + offset) % numWorkers].range;
+            uint64_t victimPacked = victim.load(std::memory_order_acquire);
+            long long victimBegin = (long long)(victimPacked & 0xFFFFFFFFu);
+            long long victimEnd = (long long)(victimPacked >> 32);
+            while (victimBegin < victimEnd) // Retry while the victim still has work
+            {
+                long long remaining = victimEnd - victimBegin;
+                if (remaining <= grain) // Too small to split: take the whole range as one chunk
+                {
+                    if (victim.compare_exchange_weak(victimPacked, PackRange(victimEnd, victimEnd), std::memory_order_acq_rel))
+                    {
+                        begin = victimBegin;
+                        end = victimEnd;
+                        return true;
+                    }
+                }
+                else
+                {
+                    long long middle = victimBegin + remaining / 2;
+                    if (victim.compare_exchange_weak(victimPacked, PackRange(victimBegin, middle), std::memory_order_acq_rel))
+                    {
+                        // Only this worker refills its own empty range, so a plain store is enough
+                        own.store(PackRange(middle, victimEnd), std::memory_order_release);
+                        stole = true;
+                        break;
+                    }
+                }
+                victimBegin = (long long)(victimPacked & 0xFFFFFFFFu); // The CAS failed: reload and retry
+                victimEnd = (long long)(victimPacked >> 32);
+            }
+        }
+        if (!stole) // Every range is empty
+        {
+            return false;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+#include <atomic>             // Includes atomics for the lock-free work ranges
+#include <condition_variable> // Includes condition variables for waking and joining the workers
+#include <cstdint>            // Includes the fixed-width integer type of the packed ranges
+#include <functional>         // Includes std::function for the task callback
+#include <memory>             // Includes unique_ptr for the per-worker slots
+#include <mutex>              // Includes the mutex guarding the job hand-off
+#include <thread>             // Includes the worker threads
+#include <vector>             // Includes the container of worker threads
+
+// Size of a cache line; per-thread data is aligned to it so threads never write to a shared line
+const int cacheLineSize = 64;
+
+// A pool of persistent worker threads that run index ranges with work stealing
+// Each worker starts with an even share of the indices and takes small chunks from its own range;
+// when it runs dry it steals the upper half of another worker's remaining range
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(int numWorkers = 0); // Starts the workers (0 = one per hardware thread)
+    ~WorkStealingPool(); // Stops and joins the workers
+
+    // Number of workers, including the calling thread, which takes part in every ParallelFor
+    int GetNumWorkers() const { return numWorkers; }
+
+    // Calls task(index, worker) for every index in [0, count) and returns when all calls finished
+    // Indices are handed out in chunks of up to grain; worker is in [0, GetNumWorkers())
+    // count must stay below 2^32 because ranges are packed into one 64-bit word
+    void ParallelFor(long long count, long long grain, const std::function<void(long long, int)>& task);
+
+private:
+    // Remaining index range of one worker, packed as (end << 32 | begin) so it updates with one CAS
+    struct alignas(cacheLineSize) WorkerRange
+    {
+        std::atomic<uint64_t> range;
+    };
+
+    void WorkerLoop(int worker); // Background thread body: waits for jobs and runs them
+    void RunWorker(int worker); // Runs chunks until no worker has work left
+    bool TakeChunk(int worker, long long& begin, long long& end); // Takes the next chunk, stealing if needed
+
+    int numWorkers; // Number of workers, including the calling thread
+    std::unique_ptr<WorkerRange[]> ranges; // One cache-line-isolated range per worker
+    std::vector<std::thread> threads; // Background workers 1..numWorkers-1
+
+    std::mutex mutex; // Guards the job hand-off below
+    std::condition_variable jobReady; // Signals the background workers that a job started
+    std::condition_variable jobDone; // Signals the caller that a worker finished the job
+    const std::function<void(long long, int)>* task; // Task of the running job
+    long long grain; // Chunk size of the running job
+    int generation; // Incremented for every job so workers run each one once
+    int busyWorkers; // Background workers still running the current job
+    bool stopping; // Tells the workers to exit
+};
@@ -0,0 +1,41 @@
+#include "timestep.h" // Includes the header file for the fixed-timestep clock
+
+// Constructor: Starts at time 0
+FixedTimestep::FixedTimestep(double stepSeconds, double maxCatchUp)
+    : step(stepSeconds), maxCatchUp(maxCatchUp)
+{
+    Reset(0.0);
+}
+
+// Restarts the clock at now with nothing accumulated
+void FixedTimestep::Reset(double now)
+{
+    lastNow = now;
+    accumulator = 0.0;
+    time = now;
+}
+
+// Adds the real time since the last call and returns the number of steps to simulate now
+int FixedTimestep::Advance(double now)
+{
+    double elapsed = now - lastNow;
+    lastNow = now;
+    if (elapsed < 0.0) // The clock went backwards; simulate nothing
+    {
+        elapsed = 0.0;
+    }
+    if (elapsed > maxCatchUp) // A stall: drop what cannot be caught up in one frame
+    {
+        time += elapsed - maxCatchUp;
+        elapsed = maxCatchUp;
+    }
+    accumulator += elapsed;
+    int steps = 0;
+    while (accumulator >= step)
+    {
+        accumulator -= step;
+        time += step;
+        steps++;
+    }
+    return steps;
+}
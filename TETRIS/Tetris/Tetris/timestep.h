@@ -0,0 +1,33 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+// Fixed-timestep clock: accumulates real time and hands it out as whole simulation steps of the same length,
+// so the simulation runs at the same speed whatever the frame rate, and catches up after a slow frame
+// Time beyond maxCatchUp seconds is dropped rather than simulated, so a long stall (a dragged window,
+// a breakpoint) does not freeze the game while it replays seconds of steps
+class FixedTimestep
+{
+public:
+    explicit FixedTimestep(double stepSeconds = 1.0 / 240.0, double maxCatchUp = 0.25); // Constructor: Starts at time 0
+
+    // Restarts the clock at now with nothing accumulated; call when the simulation starts or resumes
+    void Reset(double now);
+
+    // Adds the real time since the last call and returns the number of steps to simulate now
+    int Advance(double now);
+
+    // Length of a step in seconds
+    double GetStep() const { return step; }
+
+    // Simulated time: the time of Reset plus the steps handed out since (dropped time included)
+    double GetTime() const { return time; }
+
+    // Fraction of a step accumulated but not simulated yet, in [0, 1); rendering can interpolate with it
+    double GetAlpha() const { return accumulator / step; }
+
+private:
+    double step; // Seconds per step
+    double maxCatchUp; // Most seconds one Advance simulates
+    double lastNow; // Real time of the last Reset or Advance
+    double accumulator; // Real time not simulated yet, less than a step after each Advance
+    double time; // Simulated time
+};
@@ -0,0 +1,361 @@
+#include "trace.h" // Includes the header file for session tracing
+
+#ifdef TETRIS_TRACE
+
+#include <chrono>             // Includes the clock of the timestamps and the writer's period
+#include <condition_variable> // Includes the writer's wake-up
+#include <cstdio>             // Includes the trace file
+#include <mutex>              // Includes the locks of the thread registry and the session
+#include <thread>             // Includes the writer thread
+
+std::atomic<bool> traceEnabled(false);
+thread_local int traceMuteDepth = 0;
+
+static const uint32_t traceRingSize = 8192; // Spans a thread can have waiting for the writer (a power of two)
+static const int maxTraceThreads = 64; // Threads that can record at once; a lane is reused once its thread exits
+static const auto traceWritePeriod = std::chrono::milliseconds(20); // How often the writer drains the rings
+
+// One ended span
+struct TraceEvent
+{
+    const char* name;
+    uint64_t start; // TraceNow at the start and at the end
+    uint64_t end;
+};
+
+// A thread's spans on their way to the writer: the thread stores head, the writer stores tail
+struct TraceRing
+{
+    TraceEvent events[traceRingSize];
+    std::atomic<uint32_t> head; // Spans recorded (the next slot the thread writes)
+    std::atomic<uint32_t> tail; // Spans drained (the next slot the writer reads)
+    std::atomic<uint64_t> dropped; // Spans lost to a full ring
+    std::atomic<const char*> threadName; // Name of the lane, or null
+    std::atomic<int> tid; // Lane in the trace; a new one each time another thread takes the ring
+    std::atomic<bool> inUse; // Owned by a running thread; false once that thread exits
+};
+
+// Every thread that recorded a span or named itself; rings are never freed, so the writer reads them without a lock
+// A ring whose thread exited is taken by the next thread that registers, under a new lane
+static TraceRing* rings[maxTraceThreads];
+static std::atomic<int> numRings(0);
+static std::mutex registryMutex; // Serializes the registration of threads
+static int lastTid = 0; // Last lane handed out; guarded by registryMutex
+static std::atomic<uint64_t> unregisteredDrops(0); // Spans of the threads beyond maxTraceThreads running at once
+static thread_local TraceRing* threadRing = nullptr; // The calling thread's ring
+static thread_local bool threadExiting = false; // The thread gave its ring back; its last spans are dropped
+
+// The running session
+static std::mutex sessionMutex; // Guards everything below
+static std::condition_variable writerWake;
+static std::thread writer;
+static bool writerStopping = false;
+static FILE* traceFile = nullptr;
+static uint64_t sessionStart = 0; // TraceNow at StartTrace; older spans left in the rings are skipped
+static uint64_t sessionDropBaseline = 0; // Drops counted before the session
+
+// Monotonic time in nanoseconds, never 0
+uint64_t TraceNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() | 1;
+}
+
+static void ReleaseThreadRing();
+
+// Gives the thread's ring back when the thread exits
+struct TraceRingReleaser
+{
+    ~TraceRingReleaser() { ReleaseThreadRing(); }
+};
+static thread_local TraceRingReleaser threadRingReleaser;
+
+// Registers the calling thread on its first span; returns null while every lane is taken
+static TraceRing* GetThreadRing()
+{
+    if (threadRing == nullptr && !threadExiting)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        int count = numRings.load(std::memory_order_relaxed);
+        TraceRing* ring = nullptr;
+        bool added = false; // A new ring rather than one given back
+        for (int i = 0; i < count && ring == nullptr; i++) // A ring given back by an exited thread
+        {
+            if (!rings[i]->inUse.load(std::memory_order_acquire))
+            {
+                ring = rings[i];
+            }
+        }
+        if (ring == nullptr)
+        {
+            if (count == maxTraceThreads)
+            {
+                return nullptr;
+            }
+            ring = new TraceRing();
+            ring->head.store(0, std::memory_order_relaxed);
+            ring->tail.store(0, std::memory_order_relaxed);
+            ring->dropped.store(0, std::memory_order_relaxed);
+            rings[count] = ring;
+            added = true;
+        }
+        ring->threadName.store(nullptr, std::memory_order_relaxed);
+        ring->tid.store(++lastTid, std::memory_order_relaxed);
+        ring->inUse.store(true, std::memory_order_relaxed);
+        if (added)
+        {
+            numRings.store(count + 1, std::memory_order_release); // Publishes the ring to the writer
+        }
+        threadRing = ring;
+        (void)&threadRingReleaser; // Constructs the releaser, so it runs when this thread exits
+    }
+    return threadRing;
+}
+
+// Adds an ended span to the calling thread's ring
+void TraceRecord(const char* name, uint64_t start, uint64_t end)
+{
+    if (!traceEnabled.load(std::memory_order_relaxed)) // The trace stopped while the span was open
+    {
+        return;
+    }
+    TraceRing* ring = GetThreadRing();
+    if (ring == nullptr)
+    {
+        unregisteredDrops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= traceRingSize) // The writer is behind: drop it
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent& event = ring->events[head & (traceRingSize - 1)];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    ring->head.store(head + 1, std::memory_order_release); // Publishes the span to the writer
+}
+
+// Spans lost by every thread since the program started
+static uint64_t CountDrops()
+{
+    uint64_t dropped = unregisteredDrops.load(std::memory_order_relaxed);
+    int count = numRings.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++)
+    {
+        dropped += rings[i]->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+// Copies text into buffer as the contents of a JSON string, truncated to fit size bytes with the terminator
+static void EscapeJson(char* buffer, int size, const char* text)
+{
+    int length = 0;
+    for (const char* c = text; *c != '\0' && length + 3 <= size; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            buffer[length++] = '\\';
+        }
+        if ((unsigned char)*c >= 0x20) // Control characters cannot appear in a name
+        {
+            buffer[length++] = *c;
+        }
+    }
+    buffer[length] = '\0';
+}
+
+// Writes every span waiting in the rings; called with sessionMutex held
+static void DrainRings()
+{
+    int count = numRings.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++)
+    {
+        TraceRing& ring = *rings[i];
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        for (; tail != head; tail++)
+        {
+            const TraceEvent& event = ring.events[tail & (traceRingSize - 1)];
+            if (event.start < sessionStart) // Left over from an earlier session
+            {
+                continue;
+            }
+            // Times in microseconds with three decimals, formatted from integers
+            char name[128];
+            EscapeJson(name, sizeof(name), event.name);
+            uint64_t ts = event.start - sessionStart;
+            uint64_t dur = event.end - event.start;
+            fprintf(traceFile, ",\n{\"name\":\"%s\",\"cat\":\"tetris\",\"ph\":\"X\",\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":1,\"tid\":%d}",
+                name, (unsigned long long)(ts / 1000), (unsigned)(ts % 1000), (unsigned long long)(dur / 1000), (unsigned)(dur % 1000), ring.tid.load(std::memory_order_relaxed));
+        }
+        ring.tail.store(tail, std::memory_order_release); // Frees the slots for the thread
+    }
+}
+
+// Writes the name of a lane, if its thread set one; called with sessionMutex held
+static void WriteThreadName(const TraceRing& ring)
+{
+    const char* name = ring.threadName.load(std::memory_order_relaxed);
+    if (name != nullptr)
+    {
+        char escaped[128];
+        EscapeJson(escaped, sizeof(escaped), name);
+        fprintf(traceFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            ring.tid.load(std::memory_order_relaxed), escaped);
+    }
+}
+
+// Gives the exiting thread's ring back: its spans and name are written first if a trace is running,
+// otherwise they are discarded, and the next thread that registers takes the ring under a new lane
+static void ReleaseThreadRing()
+{
+    threadExiting = true;
+    TraceRing* ring = threadRing;
+    if (ring == nullptr)
+    {
+        return;
+    }
+    threadRing = nullptr;
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (traceFile != nullptr)
+    {
+        DrainRings();
+        WriteThreadName(*ring);
+    }
+    else
+    {
+        ring->tail.store(ring->head.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    ring->threadName.store(nullptr, std::memory_order_relaxed); // Already written; StopTrace must not repeat it
+    ring->inUse.store(false, std::memory_order_release);
+}
+
+// Writer thread body: drains the rings until the session stops
+static void RunWriter()
+{
+    std::unique_lock<std::mutex> lock(sessionMutex);
+    while (!writerStopping)
+    {
+        writerWake.wait_for(lock, traceWritePeriod, [] { return writerStopping; });
+        DrainRings();
+    }
+}
+
+// Starts recording into a new trace file
+bool StartTrace(const char* path)
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (traceFile != nullptr)
+    {
+        return false;
+    }
+    traceFile = fopen(path, "wb");
+    if (traceFile == nullptr)
+    {
+        return false;
+    }
+    fputs("{\"traceEvents\":[", traceFile);
+    fputs("\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Tetris\"}}", traceFile);
+    sessionStart = TraceNow();
+    sessionDropBaseline = CountDrops();
+    writerStopping = false;
+    writer = std::thread(RunWriter);
+    traceEnabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// Stops recording, writes the spans still in the rings and closes the file
+void StopTrace()
+{
+    traceEnabled.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        if (traceFile == nullptr)
+        {
+            return;
+        }
+        writerStopping = true;
+    }
+    writerWake.notify_one();
+    writer.join(); // Its last pass drained the rings
+
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    int count = numRings.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) // Name the lanes; a thread may have named itself at any time
+    {
+        WriteThreadName(*rings[i]); // The lanes of exited threads were named when they exited
+    }
+    fprintf(traceFile, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":\"%llu\"}}\n",
+        (unsigned long long)(CountDrops() - sessionDropBaseline));
+    fclose(traceFile);
+    traceFile = nullptr;
+}
+
+// Writes the spans the threads have ended so far, without waiting for the writer's next pass
+void FlushTrace()
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (traceFile != nullptr)
+    {
+        DrainRings();
+    }
+}
+
+// True between StartTrace and StopTrace
+bool IsTracing()
+{
+    return traceEnabled.load(std::memory_order_relaxed);
+}
+
+// Spans lost this session because a thread's ring was full
+uint64_t GetTraceDroppedSpans()
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return CountDrops() - sessionDropBaseline;
+}
+
+// Names the calling thread's lane in the trace
+void SetTraceThreadName(const char* name)
+{
+    TraceRing* ring = GetThreadRing();
+    if (ring != nullptr)
+    {
+        ring->threadName.store(name, std::memory_order_relaxed);
+    }
+}
+
+#else
+
+// Tracing is compiled out: there is never a trace to record
+bool StartTrace(const char*)
+{
+    return false;
+}
+
+void StopTrace()
+{
+}
+
+void FlushTrace()
+{
+}
+
+bool IsTracing()
+{
+    return false;
+}
+
+uint64_t GetTraceDroppedSpans()
+{
+    return 0;
+}
+
+void SetTraceThreadName(const char*)
+{
+}
+
+#endif
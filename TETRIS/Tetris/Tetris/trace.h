@@ -0,0 +1,92 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <cstdint> // Includes the fixed-width integer types of the timestamps
+
+// Session tracing: scoped spans from any thread, written as a Chrome trace (JSON) that chrome://tracing and
+// Perfetto open, one lane per thread
+// A span is two clock reads and one store into its thread's ring; the rings are single-producer, single-consumer,
+// so recording never takes a lock, and a writer thread drains them into the file in the background
+// A thread's ring is given back when it exits, after its spans are written; up to 64 threads record at once, and the
+// spans of any more are counted as dropped
+// Spans are only recorded between StartTrace and StopTrace; otherwise a span costs one relaxed load
+// Without TETRIS_TRACE the spans compile to nothing and StartTrace always fails
+
+// Starts recording into a new trace file; returns false if it cannot be created or a trace is already running
+bool StartTrace(const char* path);
+
+// Stops recording, writes the spans still in the rings and closes the file
+void StopTrace();
+
+// Writes the spans the threads have ended so far, without waiting for the writer's next pass
+void FlushTrace();
+
+// True between StartTrace and StopTrace
+bool IsTracing();
+
+// Spans lost this session because a thread's ring was full when it ended them
+uint64_t GetTraceDroppedSpans();
+
+// Names the calling thread's lane in the trace; name must outlive the program (a string literal)
+void SetTraceThreadName(const char* name);
+
+#ifdef TETRIS_TRACE
+
+#include <atomic> // Includes the flag every span checks
+
+extern std::atomic<bool> traceEnabled; // A trace is running
+extern thread_local int traceMuteDepth; // TraceMute scopes open on this thread
+
+// Monotonic time in nanoseconds, never 0
+uint64_t TraceNow();
+
+// Adds an ended span to the calling thread's ring
+void TraceRecord(const char* name, uint64_t start, uint64_t end);
+
+// Times its scope, or up to End, as one span; name must outlive the program (a string literal or a table entry)
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* name)
+        : name(name), start(traceEnabled.load(std::memory_order_relaxed) && traceMuteDepth == 0 ? TraceNow() : 0) {}
+    ~TraceSpan() { End(); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Ends the span before the scope does
+    void End()
+    {
+        if (start != 0) // Started while a trace was running
+        {
+            TraceRecord(name, start, TraceNow());
+            start = 0;
+        }
+    }
+
+private:
+    const char* name;
+    uint64_t start; // 0 when not recorded
+};
+
+// Stops the calling thread's spans for its scope, e.g. a search that locks thousands of hypothetical blocks
+// whose spans would only flood the ring; the search itself is timed by a span around the mute
+class TraceMute
+{
+public:
+    TraceMute() { traceMuteDepth++; }
+    ~TraceMute() { traceMuteDepth--; }
+    TraceMute(const TraceMute&) = delete;
+    TraceMute& operator=(const TraceMute&) = delete;
+};
+
+#define TRACE_SPAN(name) TraceSpan traceSpan(name)
+#define TRACE_BEGIN(span, name) TraceSpan span(name)
+#define TRACE_END(span) span.End()
+#define TRACE_MUTE() TraceMute traceMute
+
+#else
+
+#define TRACE_SPAN(name) ((void)0)
+#define TRACE_BEGIN(span, name) ((void)0)
+#define TRACE_END(span) ((void)0)
+#define TRACE_MUTE() ((void)0)
+
+#endif
@@ -0,0 +1,131 @@
+#include "transposition.h" // Includes the header file for the transposition table
+
+// Packs an entry into one word: the value in the high 56 bits, depth + 1 in the low 8 (so no entry packs to 0)
+static uint64_t PackEntry(const TableEntry& entry)
+{
+    return ((uint64_t)entry.value << 8) | (uint64_t)(entry.depth + 1);
+}
+
+// Unpacks a word written by PackEntry
+static TableEntry UnpackEntry(uint64_t data)
+{
+    TableEntry entry;
+    entry.depth = (int)(data & 0xFF) - 1;
+    entry.value = (int64_t)data >> 8; // Arithmetic shift keeps the sign
+    return entry;
+}
+
+// Constructor: Starts every counter at 0
+TableStats::TableStats()
+{
+    probes = 0;
+    hits = 0;
+    slotsScanned = 0;
+    stores = 0;
+    replacements = 0;
+}
+
+// Adds another thread's counters to these
+void TableStats::Add(const TableStats& other)
+{
+    probes += other.probes;
+    hits += other.hits;
+    slotsScanned += other.slotsScanned;
+    stores += other.stores;
+    replacements += other.replacements;
+}
+
+// Hits per probe
+double TableStats::GetHitRate() const
+{
+    return probes > 0 ? (double)hits / probes : 0.0;
+}
+
+// Slots read per probe
+double TableStats::GetSlotsPerProbe() const
+{
+    return probes > 0 ? (double)slotsScanned / probes : 0.0;
+}
+
+// Constructor: Allocates the largest power of two buckets that fits
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+    size_t numBuckets = 1;
+    while (numBuckets * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+    {
+        numBuckets *= 2;
+    }
+    buckets.reset(new Bucket[numBuckets]); // Allocated once; probing and storing never allocate
+    mask = numBuckets - 1;
+    Clear();
+}
+
+// Looks a key up; returns true and fills the entry if the table has it
+bool TranspositionTable::Probe(uint64_t key, TableEntry& entry, TableStats& stats) const
+{
+    const Bucket& bucket = buckets[key & mask];
+    stats.probes++;
+    for (int i = 0; i < slotsPerBucket; i++)
+    {
+        stats.slotsScanned++;
+        uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+        if (data == 0) // Stores fill a bucket's slots in order and never empty one, so the key is not further on
+        {
+            break;
+        }
+        uint64_t check = bucket.slots[i].check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key) // A torn slot fails this check
+        {
+            entry = UnpackEntry(data);
+            stats.hits++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Stores an entry for a key, replacing the key's old entry or the bucket's shallowest one
+void TranspositionTable::Store(uint64_t key, const TableEntry& entry, TableStats& stats)
+{
+    Bucket& bucket = buckets[key & mask];
+    int target = 0; // Slot to write
+    int targetDepth = 256; // Depth of the entry in it (-1 when empty)
+    for (int i = 0; i < slotsPerBucket; i++)
+    {
+        uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket.slots[i].check.load(std::memory_order_relaxed);
+        if (data == 0 || (check ^ data) == key) // An empty slot or the key's own entry
+        {
+            target = i;
+            targetDepth = -1;
+            break;
+        }
+        int depth = UnpackEntry(data).depth;
+        if (depth < targetDepth) // The shallowest search is the cheapest to redo
+        {
+            target = i;
+            targetDepth = depth;
+        }
+    }
+    if (targetDepth >= 0)
+    {
+        stats.replacements++;
+    }
+    stats.stores++;
+    uint64_t data = PackEntry(entry);
+    bucket.slots[target].check.store(key ^ data, std::memory_order_relaxed);
+    bucket.slots[target].data.store(data, std::memory_order_relaxed);
+}
+
+// Empties the table
+void TranspositionTable::Clear()
+{
+    for (size_t i = 0; i <= mask; i++)
+    {
+        for (int j = 0; j < slotsPerBucket; j++)
+        {
+            buckets[i].slots[j].check.store(0, std::memory_order_relaxed);
+            buckets[i].slots[j].data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
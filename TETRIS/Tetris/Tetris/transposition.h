@@ -0,0 +1,75 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+#include <atomic>      // Includes the atomic words of the lock-free slots
+#include <cstddef>     // Includes size_t for the table size
+#include <cstdint>     // Includes the 64-bit keys and packed entries
+#include <memory>      // Includes unique_ptr for the buckets
+#include "scheduler.h" // Includes the cache line size the buckets are aligned to
+
+// What a search stores about a position
+struct TableEntry
+{
+    int depth; // Depth of the search the value came from (0 to 254)
+    int64_t value; // Result of that search; must fit in 56 bits
+};
+
+// Counters of one thread's use of a table; each search thread keeps its own and the totals are summed,
+// so counting never makes the threads share a cache line
+struct alignas(cacheLineSize) TableStats
+{
+    TableStats(); // Constructor: Starts every counter at 0
+
+    // Adds another thread's counters to these
+    void Add(const TableStats& other);
+
+    double GetHitRate() const; // Hits per probe
+    double GetSlotsPerProbe() const; // Slots read per probe, the cost of a probe in memory reads
+
+    uint64_t probes; // Lookups
+    uint64_t hits; // Lookups that found their key
+    uint64_t slotsScanned; // Slots read by the lookups
+    uint64_t stores; // Entries written
+    uint64_t replacements; // Stores that overwrote another position's entry
+};
+
+// Fixed-size hash table of search results, shared by all search threads without locks
+// Each slot holds the entry and the entry XORed with its key in two atomic words:
+// a torn read or write leaves a pair that fails the check, so a race only ever costs a miss
+// Slots are grouped in buckets of one cache line; a key probes one bucket up to its first empty slot,
+// and a full bucket replaces the entry of the shallowest search
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(size_t megabytes); // Constructor: Allocates the largest power of two buckets that fits
+    TranspositionTable(const TranspositionTable&) = delete; // Shared by reference between the threads
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Looks a key up; returns true and fills the entry if the table has it
+    bool Probe(uint64_t key, TableEntry& entry, TableStats& stats) const;
+
+    // Stores an entry for a key, replacing the key's old entry or the bucket's shallowest one
+    void Store(uint64_t key, const TableEntry& entry, TableStats& stats);
+
+    // Empties the table; must not run while other threads probe or store
+    void Clear();
+
+    size_t GetNumSlots() const { return (mask + 1) * slotsPerBucket; } // Capacity in entries
+    size_t GetBytes() const { return (mask + 1) * sizeof(Bucket); } // Memory used
+
+private:
+    static const int slotsPerBucket = 4; // Four 16-byte slots fill a cache line
+
+    struct Slot
+    {
+        std::atomic<uint64_t> check; // Key XOR data
+        std::atomic<uint64_t> data; // Packed entry; 0 when the slot is empty
+    };
+
+    struct alignas(cacheLineSize) Bucket
+    {
+        Slot slots[slotsPerBucket];
+    };
+
+    std::unique_ptr<Bucket[]> buckets; // The table
+    size_t mask; // Number of buckets minus one; a key's low bits pick its bucket
+};
@@ -0,0 +1,207 @@
+#include "uicache.h" // Includes the header file for the UI cache
+#include "perfoverlay.h" // Includes the draw call counter of the frame timings overlay
+#include <rlgl.h>    // Includes the batch flush and blending switches of raylib's renderer
+#include <cmath>     // Includes floor and ceil for the label areas
+#include <cstring>   // Includes strcmp and strncpy for the label texts
+
+// Draws a rounded rectangle with a stroke
+void DrawRectangleRoundedWithStroke(Rectangle rect, float roundness, int segments, Color fillColor, Color strokeColor, float strokeThickness)
+{
+    PERF_COUNT_DRAWS(2);
+
+    // Draw the stroke (outer rectangle)
+    DrawRectangleRounded(rect, roundness, segments, strokeColor);
+
+    // Adjust the rectangle size for the inner fill
+    Rectangle innerRect = {
+        rect.x + strokeThickness,
+        rect.y + strokeThickness,
+        rect.width - 2 * strokeThickness,
+        rect.height - 2 * strokeThickness
+    };
+
+    // Draw the inner rectangle (fill)
+    DrawRectangleRounded(innerRect, roundness, segments, fillColor);
+}
+
+// Draws text with a stroke
+void DrawTextWithStroke(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color textColor, Color strokeColor, float strokeThickness)
+{
+    PERF_COUNT_DRAWS((2 * static_cast<int>(strokeThickness) + 1) * (2 * static_cast<int>(strokeThickness) + 1)); // The copies and the text
+
+    // Draw the stroke by rendering the text multiple times around the main text
+    for (int dy = -static_cast<int>(strokeThickness); dy <= static_cast<int>(strokeThickness); dy++)
+    {
+        for (int dx = -static_cast<int>(strokeThickness); dx <= static_cast<int>(strokeThickness); dx++)
+        {
+            if (dx != 0 || dy != 0) // Skip the center position
+            {
+                DrawTextEx(font, text, { position.x + dx, position.y + dy }, fontSize, spacing, strokeColor);
+            }
+        }
+    }
+
+    // Draw the main text in the center
+    DrawTextEx(font, text, position, fontSize, spacing, textColor);
+}
+
+// Source rectangle of an area of a render texture; render textures are stored bottom-up, so it flips them back
+static Rectangle FlippedArea(int x, int y, int width, int height, int textureHeight)
+{
+    return { static_cast<float>(x), static_cast<float>(textureHeight - y - height), static_cast<float>(width), static_cast<float>(-height) };
+}
+
+// Copies an area of a texture to (x, y) with blending off, so the pixels replace what is behind them
+static void DrawOpaque(Texture2D texture, Rectangle source, int x, int y)
+{
+    PERF_COUNT_DRAWS(1);
+    rlDrawRenderBatchActive(); // Blending applies when the batch is drawn, so draw what came before with it on
+    rlDisableColorBlend();
+    DrawTextureRec(texture, source, { static_cast<float>(x), static_cast<float>(y) }, WHITE);
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+}
+
+// Constructor: Starts empty; textures are created on first use, once the window is open
+UiCache::UiCache()
+{
+    for (int layer = 0; layer < maxUiLayers; layer++)
+    {
+        layers[layer] = RenderTexture2D{};
+        hasLayer[layer] = false;
+        isPainted[layer] = false;
+    }
+    for (Label& label : labels)
+    {
+        label.texture = RenderTexture2D{};
+        label.hasTexture = false;
+        label.text[0] = '\0';
+        label.layer = -1; // Never painted
+        label.x = label.y = label.width = label.height = 0;
+    }
+    paintingLayer = -1;
+    numPaints = 0;
+}
+
+// Destructor: Releases the textures while the window is still open
+UiCache::~UiCache()
+{
+    if (!IsWindowReady()) // Closing the window already released them with the rest of the GPU state
+    {
+        return;
+    }
+    for (int layer = 0; layer < maxUiLayers; layer++)
+    {
+        if (hasLayer[layer])
+        {
+            UnloadRenderTexture(layers[layer]);
+        }
+    }
+    for (Label& label : labels)
+    {
+        if (label.hasTexture)
+        {
+            UnloadRenderTexture(label.texture);
+        }
+    }
+}
+
+// Starts painting a layer if it is not cached yet
+bool UiCache::BeginLayer(int layer)
+{
+    if (isPainted[layer])
+    {
+        return false;
+    }
+    if (!hasLayer[layer])
+    {
+        layers[layer] = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
+        hasLayer[layer] = true;
+    }
+    BeginTextureMode(layers[layer]);
+    paintingLayer = layer;
+    return true;
+}
+
+// Finishes painting the layer started by BeginLayer
+void UiCache::EndLayer()
+{
+    EndTextureMode();
+    isPainted[paintingLayer] = true;
+    paintingLayer = -1;
+    numPaints++;
+}
+
+// Forgets every layer and label, so they are painted again on their next use; the textures are kept
+void UiCache::Invalidate()
+{
+    for (int layer = 0; layer < maxUiLayers; layer++)
+    {
+        isPainted[layer] = false;
+    }
+    for (Label& label : labels)
+    {
+        label.layer = -1;
+    }
+}
+
+// Draws a cached layer over the whole screen
+void UiCache::DrawLayer(int layer)
+{
+    const Texture2D& texture = layers[layer].texture;
+    DrawOpaque(texture, FlippedArea(0, 0, texture.width, texture.height, texture.height), 0, 0);
+}
+
+// Draws stroked text over a layer, painting it again only when the text changes
+void UiCache::DrawLabel(int label, int layer, Font font, const char* text, Vector2 position, float centerWidth,
+    float fontSize, float spacing, Color textColor, Color strokeColor, float strokeThickness)
+{
+    Label& cached = labels[label];
+    if (cached.layer != layer || strcmp(cached.text, text) != 0) // Paint the new text
+    {
+        strncpy(cached.text, text, maxLabelText - 1);
+        cached.text[maxLabelText - 1] = '\0';
+        cached.layer = layer;
+        Vector2 size = MeasureTextEx(font, cached.text, fontSize, spacing);
+        if (centerWidth > 0)
+        {
+            position.x += (centerWidth - size.x) / 2;
+        }
+        cached.x = static_cast<int>(std::floor(position.x - strokeThickness));
+        cached.y = static_cast<int>(std::floor(position.y - strokeThickness));
+        cached.width = static_cast<int>(std::ceil(size.x + 2 * strokeThickness)) + 1; // One more pixel for the rounding
+        cached.height = static_cast<int>(std::ceil(size.y + 2 * strokeThickness)) + 1;
+        if (cached.width <= 1 || cached.height <= 1) // Nothing to show (empty text)
+        {
+            cached.width = cached.height = 0;
+            return;
+        }
+
+        // Grow the texture to fit, never shrink it, so changing text reuses it
+        if (!cached.hasTexture || cached.texture.texture.width < cached.width || cached.texture.texture.height < cached.height)
+        {
+            int width = cached.hasTexture && cached.texture.texture.width > cached.width ? cached.texture.texture.width : cached.width;
+            int height = cached.hasTexture && cached.texture.texture.height > cached.height ? cached.texture.texture.height : cached.height;
+            if (cached.hasTexture)
+            {
+                UnloadRenderTexture(cached.texture);
+            }
+            cached.texture = LoadRenderTexture(width, height);
+            cached.hasTexture = true;
+        }
+
+        // Paint the layer's pixels under the text, then the text over them, at the texture's top-left corner
+        const Texture2D& background = layers[layer].texture;
+        BeginTextureMode(cached.texture);
+        DrawOpaque(background, FlippedArea(cached.x, cached.y, cached.width, cached.height, background.height), 0, 0);
+        DrawTextWithStroke(font, cached.text, { position.x - cached.x, position.y - cached.y }, fontSize, spacing,
+            textColor, strokeColor, strokeThickness);
+        EndTextureMode();
+        numPaints++;
+    }
+    if (cached.width > 0)
+    {
+        DrawOpaque(cached.texture.texture,
+            FlippedArea(0, 0, cached.width, cached.height, cached.texture.texture.height), cached.x, cached.y);
+    }
+}
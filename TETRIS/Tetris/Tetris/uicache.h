@@ -0,0 +1,68 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include <raylib.h> // Includes the raylib library for render textures, fonts and drawing
+
+// Draws a rounded rectangle with a stroke
+void DrawRectangleRoundedWithStroke(Rectangle rect, float roundness, int segments, Color fillColor, Color strokeColor, float strokeThickness);
+
+// Draws text with a stroke: the outline is the text drawn once per offset around it, (2t+1)^2-1 times for a stroke t
+void DrawTextWithStroke(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color textColor, Color strokeColor, float strokeThickness);
+
+const int maxUiLayers = 8; // Cached screens (one per game state)
+const int maxUiLabels = 8; // Cached pieces of changing text
+const int maxLabelText = 64; // Longest text a label holds, terminator included
+
+// Caches what the screens draw the same way every frame, so a frame costs a few textured quads instead of
+// hundreds of text and panel draws
+// A layer is a screen-sized texture with a screen's background, panels and fixed labels, painted once
+// A label is a small texture with one piece of changing text (the score) over its layer, painted again
+// only when the text changes
+// Both are opaque and drawn without blending: text painted into a texture leaves partly transparent edges,
+// so blending them again would tint the edges with whatever is behind
+class UiCache
+{
+public:
+    UiCache(); // Constructor: Starts empty; textures are created on first use, once the window is open
+    ~UiCache(); // Destructor: Releases the textures while the window is still open
+    UiCache(const UiCache&) = delete;
+    UiCache& operator=(const UiCache&) = delete;
+
+    // Starts painting a layer if it is not cached yet: returns true, and the caller draws the layer's content,
+    // background first so nothing is left transparent, then calls EndLayer; returns false if it is cached
+    bool BeginLayer(int layer);
+
+    // Finishes painting the layer started by BeginLayer
+    void EndLayer();
+
+    // Draws a cached layer over the whole screen
+    void DrawLayer(int layer);
+
+    // Draws stroked text over a layer, painting it again only when the text changes
+    // A label always uses the same font, position and style, and only over the layer it names, with nothing
+    // else drawn under it; centerWidth > 0 centers the text in that width from position.x
+    void DrawLabel(int label, int layer, Font font, const char* text, Vector2 position, float centerWidth,
+        float fontSize, float spacing, Color textColor, Color strokeColor, float strokeThickness);
+
+    // Forgets every layer and label, so they are painted again on their next use (after fonts or images load)
+    void Invalidate();
+
+    // Textures painted since the start: rises only when a layer is first drawn or a label's text changes
+    int GetNumPaints() const { return numPaints; }
+
+private:
+    // Cached text and the texture it is painted into
+    struct Label
+    {
+        RenderTexture2D texture; // Grows to the largest text the label held
+        bool hasTexture;
+        char text[maxLabelText]; // Text the texture shows
+        int layer; // Layer the texture was painted over
+        int x, y, width, height; // Screen area the text covers, stroke included
+    };
+
+    RenderTexture2D layers[maxUiLayers]; // Screen-sized textures
+    bool hasLayer[maxUiLayers]; // The layer has been created
+    bool isPainted[maxUiLayers]; // The layer has been painted
+    Label labels[maxUiLabels];
+    int paintingLayer; // Layer between BeginLayer and EndLayer (-1 = none)
+    int numPaints;
+};
@@ -0,0 +1,98 @@
+#include "versus.h" // Includes the header file for the versus match
+
+// Constructor: Starts an empty match (no players)
+Match::Match()
+{
+    numPlayers = 0;
+    for (double& time : gravityTime)
+    {
+        time = 0;
+    }
+}
+
+// Starts a match; every player gets the same seed, so the same blocks and the same garbage holes
+void Match::Start(int count, uint64_t seed)
+{
+    numPlayers = count < maxVersusPlayers ? count : maxVersusPlayers;
+    for (int player = 0; player < numPlayers; player++)
+    {
+        players[player].Reset(seed);
+        gravityTime[player] = 0; // The first gravity tick is a full interval away
+    }
+}
+
+// Runs one simulation step of gravity on every player still in; each falls at the speed of its own score
+void Match::StepGravity(double seconds)
+{
+    for (int player = 0; player < numPlayers; player++)
+    {
+        Game& game = players[player];
+        if (game.gameOver)
+        {
+            continue;
+        }
+        gravityTime[player] += seconds;
+        double interval = CalculationInterval(game.score);
+        if (gravityTime[player] >= interval) // The interval has passed: move the block down
+        {
+            gravityTime[player] -= interval;
+            game.MoveBlockDown();
+        }
+    }
+}
+
+// Hands the garbage each player sent since the last call to the player it attacks
+void Match::SendGarbage()
+{
+    for (int player = 0; player < numPlayers; player++)
+    {
+        int rows = players[player].TakeGarbage();
+        int target = GetTarget(player);
+        if (rows > 0 && target != player) // The last player standing has nobody to attack
+        {
+            players[target].ReceiveGarbage(rows);
+        }
+    }
+}
+
+// The player a player's garbage goes to: the next one still in
+int Match::GetTarget(int player) const
+{
+    for (int step = 1; step < numPlayers; step++)
+    {
+        int target = (player + step) % numPlayers;
+        if (!players[target].gameOver)
+        {
+            return target;
+        }
+    }
+    return player; // Everyone else is out
+}
+
+// Players whose game is not over
+int Match::GetPlayersLeft() const
+{
+    int left = 0;
+    for (int player = 0; player < numPlayers; player++)
+    {
+        left += players[player].gameOver ? 0 : 1;
+    }
+    return left;
+}
+
+// The player left standing once the match is over
+int Match::GetWinner() const
+{
+    if (GetPlayersLeft() != 1)
+    {
+        return -1;
+    }
+    for (int player = 0; player < numPlayers; player++)
+    {
+        if (!players[player].gameOver)
+        {
+            return player;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,44 @@
+#pragma once // Ensures the header file is included only once during compilation
+#include "game.h" // Includes the Game rules each player's board runs on
+
+const int maxVersusPlayers = 4; // Boards a match can have
+
+// A local versus match: two to four games side by side, attacking each other with garbage rows
+// Each player attacks the next player still in, wrapping around; the last player standing wins
+// Has no rendering or input, so the caller applies each player's inputs and draws the boards
+class Match
+{
+public:
+    Match(); // Constructor: Starts an empty match (no players)
+
+    // Starts a match; every player gets the same seed, so the same blocks and the same garbage holes
+    void Start(int numPlayers, uint64_t seed);
+
+    // Runs one simulation step of gravity on every player still in
+    void StepGravity(double seconds);
+
+    // Hands the garbage each player sent since the last call to the player it attacks
+    // Call after the frame's inputs and gravity steps, so rows sent by either rise on the opponent's next lock
+    void SendGarbage();
+
+    Game& GetPlayer(int player) { return players[player]; }
+    const Game& GetPlayer(int player) const { return players[player]; }
+    int GetNumPlayers() const { return numPlayers; }
+
+    // The player a player's garbage goes to: the next one still in (itself when it is the last one)
+    int GetTarget(int player) const;
+
+    // Players whose game is not over
+    int GetPlayersLeft() const;
+
+    // True once at most one player is left
+    bool IsOver() const { return numPlayers > 0 && GetPlayersLeft() <= 1; }
+
+    // The player left standing once the match is over; -1 while it runs or if the last players went out together
+    int GetWinner() const;
+
+private:
+    Game players[maxVersusPlayers]; // The boards, in the order they are drawn
+    double gravityTime[maxVersusPlayers]; // Simulated time since each player's last gravity tick
+    int numPlayers; // Players in the match
+};
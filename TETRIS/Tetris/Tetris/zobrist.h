@@ -0,0 +1,112 @@
+#pragma once // Ensures the header file is included only once during compilation
+
+#include <cstdint> // Includes the 64-bit keys
+#include "bitboard.h" // Includes the RowMask type and the wall width
+#include "randomizer.h" // Includes numBlockTypes and queueCapacity
+
+// Zobrist keys: a position's hash is the XOR of one key per feature, so changing a feature
+// updates the hash with an XOR or two instead of hashing the whole position again
+// The keys are computed at compile time, so every build and platform hashes the same way
+
+const uint64_t zobristSeed = 0x5A0B121574E7121Full; // Start of the key sequence
+const int zobristChunkBits = 5; // A row's playfield bits are keyed in chunks of five
+const int zobristChunkValues = 1 << zobristChunkBits;
+
+// SplitMix64 step, usable at compile time
+constexpr uint64_t ZobristMix(uint64_t& state)
+{
+    uint64_t value = (state += 0x9E3779B97F4A7C15ull);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Keys of the cells of a board with the given geometry
+template <int Rows, int Cols>
+struct ZobristBoardKeys
+{
+    static const int numChunks = (Cols + zobristChunkBits - 1) / zobristChunkBits; // Chunks of a row
+    uint64_t cells[Rows][Cols]; // Key of each filled cell
+    // Keys of the 5-column chunks of each row: the XOR of the chunk's filled cells' keys,
+    // so filling one cell and moving a whole row change the hash the same way
+    // An empty chunk's key is 0, so an empty board hashes to 0
+    uint64_t rowChunks[Rows][numChunks][zobristChunkValues];
+};
+
+// Fills a board's tables from the fixed seed, row by row, so boards that share rows share their keys
+template <int Rows, int Cols>
+constexpr ZobristBoardKeys<Rows, Cols> MakeZobristBoardKeys()
+{
+    ZobristBoardKeys<Rows, Cols> keys{};
+    uint64_t state = zobristSeed;
+    for (int row = 0; row < Rows; row++)
+    {
+        for (int column = 0; column < Cols; column++)
+        {
+            keys.cells[row][column] = ZobristMix(state);
+        }
+        for (int chunk = 0; chunk < keys.numChunks; chunk++)
+        {
+            for (int value = 0; value < zobristChunkValues; value++) // Every combination of the chunk's cells
+            {
+                uint64_t key = 0; // Empty chunks add nothing
+                for (int bit = 0; bit < zobristChunkBits && chunk * zobristChunkBits + bit < Cols; bit++)
+                {
+                    if (value & (1 << bit))
+                    {
+                        key ^= keys.cells[row][chunk * zobristChunkBits + bit];
+                    }
+                }
+                keys.rowChunks[row][chunk][value] = key;
+            }
+        }
+    }
+    return keys;
+}
+
+// The keys of each board geometry, shared by every translation unit
+template <int Rows, int Cols>
+inline constexpr ZobristBoardKeys<Rows, Cols> zobristBoardKeys = MakeZobristBoardKeys<Rows, Cols>();
+
+// Returns the key of a row's cells (a bitboard row, walls included) on a given row of a board
+template <int Rows, int Cols>
+inline uint64_t ZobristRowKey(int row, uint32_t cells)
+{
+    const ZobristBoardKeys<Rows, Cols>& keys = zobristBoardKeys<Rows, Cols>;
+    uint32_t playfield = (cells >> wallWidth) & ((1u << Cols) - 1); // Column 0 in bit 0, walls dropped
+    uint64_t key = 0;
+    for (int chunk = 0; chunk < keys.numChunks; chunk++) // Unrolled: the chunk count is a constant
+    {
+        key ^= keys.rowChunks[row][chunk][(playfield >> (chunk * zobristChunkBits)) & (zobristChunkValues - 1)];
+    }
+    return key;
+}
+
+// Keys of the blocks
+struct ZobristKeys
+{
+    uint64_t currentBlock[numBlockTypes + 1]; // Key of the current block, by block ID
+    uint64_t queuedBlocks[queueCapacity][numBlockTypes + 1]; // Key of each queue slot, by block ID
+};
+
+// Fills the tables from the fixed seed; the block keys follow the 200 cell keys of the standard 20x10 board
+// in the sequence, so hashes of the standard game stay the same whatever other boards exist
+constexpr ZobristKeys MakeZobristKeys()
+{
+    ZobristKeys keys{};
+    uint64_t state = zobristSeed + 200 * 0x9E3779B97F4A7C15ull; // Skip the cell keys: each step adds the constant
+    for (int id = 0; id <= numBlockTypes; id++)
+    {
+        keys.currentBlock[id] = ZobristMix(state);
+    }
+    for (int slot = 0; slot < queueCapacity; slot++)
+    {
+        for (int id = 0; id <= numBlockTypes; id++)
+        {
+            keys.queuedBlocks[slot][id] = ZobristMix(state);
+        }
+    }
+    return keys;
+}
+
+inline constexpr ZobristKeys zobristKeys = MakeZobristKeys(); // The keys, shared by every translation unit
@@ -0,0 +1,108 @@
+// Batch simulator: plays one game per seed with a policy on every core and prints aggregate results
+// Usage: tetris_batch [--seeds FIRST:COUNT] [--policy random|greedy|bot|beam] [--threads N] [--max-pieces N]
+//                     [--gravity SECONDS|fastest]
+// --gravity plays the games one after another with the planner under that gravity interval instead of a policy,
+// and reports the decisions that missed their deadline
+#include "batch.h" // Includes the batch runner
+#include <cstdio>  // Includes printf for the report
+#include <cstdlib> // Includes strtoul, atoi and atof
+#include <cstring> // Includes strcmp for the arguments
+
+// Prints one distribution as a table row
+static void PrintDistribution(const char* name, const Distribution& distribution)
+{
+    printf("%-8s %10.1f %10.1f %8d %8d %8d %8d %8d\n", name, distribution.mean, distribution.stddev,
+        distribution.min, distribution.p50, distribution.p90, distribution.p99, distribution.max);
+}
+
+// Prints the options
+static void PrintUsage()
+{
+    fprintf(stderr, "usage: tetris_batch [--seeds FIRST:COUNT] [--policy random|greedy|bot|beam] [--threads N] [--max-pieces N] [--gravity SECONDS|fastest]\n");
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int firstSeed = 1; // First seed of the range
+    long long numGames = 10000; // Number of seeds (games) in the range
+    const char* policyName = "greedy";
+    int numWorkers = 0; // One worker per core
+    int maxPieces = 10000; // Cap for policies that never top out
+    double gravitySeconds = 0; // 0 plays the policy with no gravity
+
+    for (int i = 1; i < argc; i++) // Every option takes a value
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--seeds") == 0)
+        {
+            char* rest = nullptr;
+            firstSeed = (unsigned int)strtoul(argv[++i], &rest, 10);
+            if (*rest == ':')
+            {
+                numGames = atoll(rest + 1);
+            }
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--policy") == 0)
+        {
+            policyName = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0)
+        {
+            numWorkers = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--max-pieces") == 0)
+        {
+            maxPieces = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--gravity") == 0)
+        {
+            i++;
+            gravitySeconds = strcmp(argv[i], "fastest") == 0 ? FastestGravityInterval() : atof(argv[i]);
+            if (gravitySeconds <= 0)
+            {
+                fprintf(stderr, "gravity interval must be positive: %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else // An unknown option, or one missing its value: never run the default batch instead
+        {
+            fprintf(stderr, "unknown option or missing value: %s\n", argv[i]);
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (gravitySeconds > 0)
+    {
+        GravityResults gravity = RunGravityGames(firstSeed, numGames, gravitySeconds, numWorkers, maxPieces);
+        printf("games:    %lld (seeds %u..%u, planner under %.1f ms gravity)\n", gravity.games, firstSeed,
+            firstSeed + (unsigned int)(gravity.games - 1), gravity.gravitySeconds * 1000);
+        printf("pieces:   %lld in %.1f s of game time (%.2f pieces/s)\n", gravity.pieces, gravity.simulatedSeconds,
+            gravity.pieces / gravity.simulatedSeconds);
+        printf("latency:  p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", gravity.p50Ms, gravity.p99Ms, gravity.maxMs);
+        printf("missed:   %lld of %lld deadlines, %lld frames, %lld blocks locked by gravity\n", gravity.missedDeadlines,
+            gravity.decisions, gravity.missedFrames, gravity.lostBlocks);
+        printf("\n%-8s %10s %10s %8s %8s %8s %8s %8s\n", "", "mean", "stddev", "min", "p50", "p90", "p99", "max");
+        PrintDistribution("score", gravity.score);
+        return 0;
+    }
+
+    Policy policy = FindPolicy(policyName);
+    if (policy == nullptr)
+    {
+        fprintf(stderr, "unknown policy %s (use random, greedy, bot or beam)\n", policyName);
+        return 2;
+    }
+
+    BatchResults results = RunBatch(firstSeed, numGames, policy, numWorkers, maxPieces);
+
+    printf("games:    %lld (seeds %u..%u, policy %s)\n", results.games, firstSeed, firstSeed + (unsigned int)(results.games - 1), policyName);
+    printf("threads:  %d\n", results.workers);
+    printf("time:     %.3f s (%.0f games/s, %.2f M pieces/s)\n", results.seconds,
+        results.games / results.seconds, results.totalPieces / results.seconds / 1e6);
+    printf("\n%-8s %10s %10s %8s %8s %8s %8s %8s\n", "", "mean", "stddev", "min", "p50", "p90", "p99", "max");
+    PrintDistribution("score", results.score);
+    PrintDistribution("lines", results.lines);
+    PrintDistribution("pieces", results.pieces);
+    PrintDistribution("length", results.length);
+    return 0;
+}
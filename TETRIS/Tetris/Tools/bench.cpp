@@ -0,0 +1,500 @@
+// Microbenchmarks of the engine's hot paths: row clearing, collision checks, board geometries, drops, locks, the bag, whole games and trace spans
+// Each benchmark is calibrated to run for about --min-time seconds per sample; the median of the samples is reported
+// with the spread between the fastest and slowest sample, and the heap allocations per operation
+// Usage: tetris_bench [--filter TEXT] [--min-time SECONDS] [--samples N] [--json FILE] [--baseline FILE] [--threshold PERCENT]
+// --json writes the results for a later --baseline run, which prints the change of each benchmark and exits with 1
+// if one got slower by more than the threshold (10% by default) or started allocating
+// Operations that need a fresh board copy a prepared one first; the grid/copy and game/copy rows give that cost
+#include "game.h"        // Includes the headless Game rules
+#include "trace.h"       // Includes the session trace's spans
+#include "allocations.h" // Includes the allocation counter
+#include <algorithm>     // Includes sort for the medians
+#include <chrono>        // Includes the clock for the timings
+#include <cstdio>        // Includes printf and the JSON files
+#include <cstdlib>       // Includes atof and atoi
+#include <cstring>       // Includes strcmp and strstr
+#include <string>        // Includes the benchmark names
+#include <vector>        // Includes the list of results
+
+// Keeps the compiler from optimizing a value, and the work that produced it, away
+template <typename T>
+inline void KeepValue(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value; // An address escaping through a volatile keeps the value alive
+#endif
+}
+
+// Result of one benchmark
+struct BenchResult
+{
+    std::string name;
+    double nsPerOp; // Median over the samples
+    double spread; // (slowest - fastest) / median, in percent
+    double allocsPerOp;
+};
+
+// Settings shared by every benchmark
+struct BenchSettings
+{
+    const char* filter; // Only benchmarks whose name contains this run (nullptr = all)
+    double minTime; // Seconds per sample
+    int samples;
+};
+
+// Runs a benchmark body that performs iterations operations, and records the result
+// Calibration doubles the iterations until one sample takes minTime, then the samples are timed
+template <typename Body>
+static void RunBench(const char* name, const BenchSettings& settings, std::vector<BenchResult>& results, Body body)
+{
+    if (settings.filter != nullptr && strstr(name, settings.filter) == nullptr)
+    {
+        return;
+    }
+    long long iterations = 1;
+    while (true) // Calibrate
+    {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds >= settings.minTime || iterations >= (1ll << 40))
+        {
+            break;
+        }
+        iterations *= seconds > settings.minTime / 16 ? 2 : 8; // Jump faster while far from the target
+    }
+
+    std::vector<double> samples;
+    samples.reserve(settings.samples); // Allocated before counting, so only the body's allocations count
+    long long allocations = GetAllocationCount();
+    for (int sample = 0; sample < settings.samples; sample++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        samples.push_back(seconds * 1e9 / iterations);
+    }
+    allocations = GetAllocationCount() - allocations;
+    std::sort(samples.begin(), samples.end());
+    BenchResult result;
+    result.name = name;
+    result.nsPerOp = samples[samples.size() / 2];
+    result.spread = result.nsPerOp > 0 ? 100.0 * (samples.back() - samples.front()) / result.nsPerOp : 0.0;
+    result.allocsPerOp = (double)allocations / ((double)iterations * settings.samples);
+    results.push_back(result);
+    printf("%-32s %12.2f ns/op  +-%5.1f%%  %8.3f allocs/op\n", name, result.nsPerOp, result.spread / 2, result.allocsPerOp);
+    fflush(stdout);
+}
+
+// Builds a grid with height rows of stack, of which the bottom fullRows rows are full
+// The other stack rows each miss one cell, in a different column per row, so they never clear
+template <typename G = Grid>
+static G MakeStack(int height, int fullRows)
+{
+    G grid;
+    for (int i = 0; i < height; i++)
+    {
+        int row = grid.GetNumRows() - 1 - i;
+        for (int column = 0; column < grid.GetNumCols(); column++)
+        {
+            if (i < fullRows || column != (i * 3) % grid.GetNumCols())
+            {
+                grid.SetCell(row, column, 1 + (row + column) % numBlockTypes);
+            }
+        }
+    }
+    return grid;
+}
+
+// Places a block where it lands when dropped straight down from its spawn position
+static Block LandingBlock(const Grid& grid, int id)
+{
+    Block block(id);
+    while (grid.PieceFits(block.GetRowOffset() + 1, block.GetColumnOffset(), block.GetRowMasks()))
+    {
+        block.Move(1, 0);
+    }
+    return block;
+}
+
+// The same board operations on each compiled board geometry: copying, clearing rows under a 10-row stack,
+// and fitting every block at every column of its spawn rotation over the stack
+template <typename G>
+static void RunGeometryBenches(const char* geometry, const BenchSettings& settings, std::vector<BenchResult>& results)
+{
+    char name[64];
+    G stack = MakeStack<G>(10, 0);
+    snprintf(name, sizeof(name), "geometry/%s/copy", geometry);
+    RunBench(name, settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            G grid = stack;
+            KeepValue(grid);
+        }
+    });
+    for (int fullRows = 0; fullRows <= 4; fullRows += 4)
+    {
+        G grid = MakeStack<G>(10, fullRows);
+        snprintf(name, sizeof(name), "geometry/%s/clear_rows/full%d", geometry, fullRows);
+        RunBench(name, settings, results, [&](long long iterations) {
+            for (long long i = 0; i < iterations; i++)
+            {
+                G copy = grid;
+                KeepValue(copy.ClearFullRows());
+                KeepValue(copy);
+            }
+        });
+    }
+    snprintf(name, sizeof(name), "geometry/%s/add_garbage/rows2", geometry); // Versus garbage: one shift of the whole stack
+    RunBench(name, settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            G copy = stack;
+            KeepValue(copy.AddGarbageRows(2, (int)(i % G::numCols), GARBAGE_CELL));
+            KeepValue(copy);
+        }
+    });
+    snprintf(name, sizeof(name), "geometry/%s/piece_fits", geometry);
+    int row = G::numRows - 12; // Just above the stack, so the lower rows of tall blocks reach into it
+    RunBench(name, settings, results, [&](long long iterations) {
+        int fits = 0;
+        for (long long i = 0; i < iterations; i++)
+        {
+            const PieceRotation& rotation = pieceShapes[1 + i % numBlockTypes].rotations[0];
+            fits += stack.PieceFits(row, (int)(i % G::numCols) - 1, rotation.rowMasks);
+        }
+        KeepValue(fits);
+    });
+}
+
+// Plays the headless runner's scripted game: random rotations and shifts from a fixed xorshift state
+// Returns the number of blocks placed
+static int PlayScriptedGame(Game& game, uint64_t seed, int maxPieces)
+{
+    game.Reset(seed);
+    unsigned int state = 2463534242u;
+    while (!game.gameOver && game.blocksPlaced < maxPieces)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int turns = state & 3;
+        int shift = (int)((state >> 2) % 11) - 5;
+        for (int turn = 0; turn < turns; turn++)
+        {
+            game.ApplyInput(INPUT_ROTATE);
+        }
+        for (int step = 0; step < (shift < 0 ? -shift : shift); step++)
+        {
+            game.ApplyInput(shift < 0 ? INPUT_LEFT : INPUT_RIGHT);
+        }
+        game.ApplyInput(INPUT_DROP);
+    }
+    return game.blocksPlaced;
+}
+
+// Writes the results as JSON, one benchmark per line
+static bool WriteJson(const char* path, const std::vector<BenchResult>& results)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"spread_percent\": %.2f, \"allocs_per_op\": %.4f}%s\n",
+            results[i].name.c_str(), results[i].nsPerOp, results[i].spread, results[i].allocsPerOp,
+            i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+// Reads results written by WriteJson; returns false if the file cannot be read
+static bool ReadJson(const char* path, std::vector<BenchResult>& results)
+{
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        char name[256];
+        BenchResult result;
+        if (sscanf(line, " {\"name\": \"%255[^\"]\", \"ns_per_op\": %lf, \"spread_percent\": %lf, \"allocs_per_op\": %lf",
+                name, &result.nsPerOp, &result.spread, &result.allocsPerOp) == 4)
+        {
+            result.name = name;
+            results.push_back(result);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// Prints each benchmark's change against the baseline; returns the number of regressions
+static int CompareWithBaseline(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline, double threshold)
+{
+    int regressions = 0;
+    printf("\n%-32s %12s %12s %9s\n", "compared with baseline", "baseline", "now", "change");
+    for (const BenchResult& result : results)
+    {
+        const BenchResult* before = nullptr;
+        for (const BenchResult& candidate : baseline)
+        {
+            if (candidate.name == result.name)
+            {
+                before = &candidate;
+            }
+        }
+        if (before == nullptr)
+        {
+            printf("%-32s %12s %12.2f %9s\n", result.name.c_str(), "-", result.nsPerOp, "new");
+            continue;
+        }
+        double change = before->nsPerOp > 0 ? 100.0 * (result.nsPerOp - before->nsPerOp) / before->nsPerOp : 0.0;
+        bool slower = change > threshold;
+        bool allocates = result.allocsPerOp > before->allocsPerOp + 1e-9;
+        printf("%-32s %12.2f %12.2f %+8.1f%%%s%s\n", result.name.c_str(), before->nsPerOp, result.nsPerOp, change,
+            slower ? "  SLOWER" : "", allocates ? "  ALLOCATES" : "");
+        regressions += slower || allocates;
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv)
+{
+    BenchSettings settings = { nullptr, 0.05, 7 };
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--filter") == 0)
+        {
+            settings.filter = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--min-time") == 0)
+        {
+            settings.minTime = atof(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--samples") == 0)
+        {
+            settings.samples = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--json") == 0)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--baseline") == 0)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--threshold") == 0)
+        {
+            threshold = atof(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (settings.samples < 1 || settings.minTime <= 0)
+    {
+        fprintf(stderr, "samples and min-time must be positive\n");
+        return 2;
+    }
+    std::vector<BenchResult> baseline;
+    if (baselinePath != nullptr && !ReadJson(baselinePath, baseline))
+    {
+        fprintf(stderr, "cannot read %s\n", baselinePath);
+        return 2;
+    }
+
+    std::vector<BenchResult> results;
+    results.reserve(64); // Allocated before any benchmark counts allocations
+
+    // Copy costs, included in the benchmarks that start from a prepared board
+    Grid stack = MakeStack(10, 0);
+    RunBench("grid/copy", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            Grid grid = stack;
+            KeepValue(grid);
+        }
+    });
+    Game prepared;
+    prepared.Reset(1);
+    prepared.LoadGrid(MakeStack(6, 0));
+    RunBench("game/copy", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            Game game = prepared;
+            KeepValue(game);
+        }
+    });
+
+    // Grid::ClearFullRows with 0 to 4 full rows under stacks of several heights
+    const int heights[3] = { 4, 10, 16 };
+    for (int height : heights)
+    {
+        for (int fullRows = 0; fullRows <= 4; fullRows++)
+        {
+            Grid grid = MakeStack(height, fullRows);
+            char name[64];
+            snprintf(name, sizeof(name), "grid/clear_rows/full%d/height%d", fullRows, height);
+            RunBench(name, settings, results, [&](long long iterations) {
+                for (long long i = 0; i < iterations; i++)
+                {
+                    Grid copy = grid;
+                    KeepValue(copy.ClearFullRows());
+                    KeepValue(copy);
+                }
+            });
+        }
+    }
+
+    // The standard board, a board twice as tall and the wide board
+    RunGeometryBenches<Grid>("20x10", settings, results);
+    RunGeometryBenches<TallGrid>("40x10", settings, results);
+    RunGeometryBenches<WideGrid>("20x16", settings, results);
+
+    // Game::BlockFits is Grid::PieceFits on the current block: at spawn, resting on a stack and past a wall
+    // (the old IsBlockOutside check is the wall case: the grid's wall bits reject it in the same pass)
+    Block spawned[numBlockTypes];
+    Block resting[numBlockTypes];
+    Block outside[numBlockTypes];
+    for (int id = 1; id <= numBlockTypes; id++)
+    {
+        spawned[id - 1] = Block(id);
+        resting[id - 1] = LandingBlock(stack, id);
+        outside[id - 1] = Block(id);
+        outside[id - 1].Move(0, 9); // Pushed into the right wall
+    }
+    const Block* fitCases[3] = { spawned, resting, outside };
+    const char* fitNames[3] = { "game/block_fits/spawn", "game/block_fits/stack", "game/block_fits/outside" };
+    for (int c = 0; c < 3; c++)
+    {
+        const Block* blocks = fitCases[c];
+        RunBench(fitNames[c], settings, results, [&](long long iterations) {
+            int fits = 0;
+            for (long long i = 0; i < iterations; i++)
+            {
+                const Block& block = blocks[i % numBlockTypes];
+                fits += stack.PieceFits(block.GetRowOffset(), block.GetColumnOffset(), block.GetRowMasks());
+            }
+            KeepValue(fits);
+        });
+    }
+
+    // Game::Dropblock from the spawn row and Game::LockBlock at the landing row, on a 6-row stack
+    RunBench("game/drop_from_spawn", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            Game game = prepared;
+            game.ApplyInput(INPUT_DROP);
+            KeepValue(game);
+        }
+    });
+    Block landing = LandingBlock(prepared.GetGrid(), prepared.GetCurrentBlock().id);
+    RunBench("game/lock_block", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            Game game = prepared;
+            game.PlaceBlock(landing);
+            KeepValue(game);
+        }
+    });
+
+    // Game::Save and Game::Restore: the fixed-size copies rollback and undo take, on a game mid-stack
+    GameSnapshot snapshot;
+    RunBench("game/snapshot/save", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            prepared.Save(snapshot);
+            KeepValue(snapshot);
+        }
+    });
+    Game restored;
+    RunBench("game/snapshot/restore", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            restored.Restore(snapshot);
+            KeepValue(restored);
+        }
+    });
+
+    // Game::GetRandomBlock: a block dealt from the bag through the queue
+    BlockBag bag;
+    bag.Seed(1);
+    PieceQueue queue;
+    queue.Fill(bag);
+    RunBench("game/next_block", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            Block block(queue.Pop(bag));
+            KeepValue(block);
+        }
+    });
+
+    // A whole scripted game, the headless runner's script
+    Game scripted;
+    RunBench("game/scripted_game", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            KeepValue(PlayScriptedGame(scripted, 1, 1000));
+        }
+    });
+
+    // A span while no trace is recording, then one recorded and written to a trace file
+    // The recorded spans are flushed every 4096, so the ring never fills; the flush's formatting, which the writer
+    // thread does in the game, is counted in
+    RunBench("trace/span_idle", settings, results, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++)
+        {
+            TRACE_SPAN("bench");
+            KeepValue(i);
+        }
+    });
+    const char* benchTracePath = "tetris_bench_trace.json";
+    if (StartTrace(benchTracePath))
+    {
+        RunBench("trace/span_recorded", settings, results, [&](long long iterations) {
+            for (long long i = 0; i < iterations; i++)
+            {
+                {
+                    TRACE_SPAN("bench");
+                    KeepValue(i);
+                }
+                if ((i & 4095) == 4095)
+                {
+                    FlushTrace();
+                }
+            }
+            FlushTrace();
+        });
+        StopTrace();
+        remove(benchTracePath);
+    }
+
+    if (jsonPath != nullptr && !WriteJson(jsonPath, results))
+    {
+        fprintf(stderr, "cannot write %s\n", jsonPath);
+        return 2;
+    }
+    if (baselinePath != nullptr)
+    {
+        int regressions = CompareWithBaseline(results, baseline, threshold);
+        printf("\n%d regression%s (threshold %.1f%%)\n", regressions, regressions == 1 ? "" : "s", threshold);
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Evalbench: times the board evaluator per board and in batches, with the scalar and the AVX2 kernels
+// The boards come from seeded games of random placements, so every run scores the same boards;
+// the three paths must agree on every score before any time is printed
+// Usage: tetris_evalbench [--boards N] [--rounds N] [--seed N]
+#include "evaluator.h" // Includes the per-board and batched evaluators
+#include "movegen.h"   // Includes the move generator dealing the random placements
+#include "randomizer.h" // Includes the seeded generator picking the placements
+#include <chrono>      // Includes the clock for the timings
+#include <cstdio>      // Includes printf
+#include <cstdlib>     // Includes strtoull and atoi
+#include <cstring>     // Includes strcmp and memcmp
+
+// Times rounds of a pass over the boards and returns the nanoseconds per board
+template <typename Pass>
+static double TimeBoards(int numBoards, int rounds, Pass pass)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++)
+    {
+        pass();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((double)numBoards * rounds);
+}
+
+int main(int argc, char** argv)
+{
+    int numBoards = 4096; // Boards scored per round
+    int rounds = 200; // Passes over the boards per path
+    uint64_t seed = 1; // Seed of the games the boards come from
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--boards") == 0)
+        {
+            numBoards = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--rounds") == 0)
+        {
+            rounds = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (numBoards < 1 || rounds < 1)
+    {
+        fprintf(stderr, "boards and rounds must be positive\n");
+        return 2;
+    }
+    numBoards = (numBoards + boardBatchSize - 1) / boardBatchSize * boardBatchSize; // Whole batches only
+
+    // Collect the boards of random games, restarting whenever one tops out
+    Grid* grids = new Grid[numBoards];
+    int* lines = new int[numBoards];
+    Game game;
+    game.Reset(seed);
+    Random random(seed);
+    MoveGenerator generator;
+    for (int i = 0; i < numBoards; i++)
+    {
+        int numPlacements = game.gameOver ? 0 : generator.Generate(game.GetGrid(), game.GetCurrentBlock());
+        if (numPlacements == 0)
+        {
+            game.Reset();
+            numPlacements = generator.Generate(game.GetGrid(), game.GetCurrentBlock());
+        }
+        int before = game.linesCleared;
+        game.PlaceBlock(generator.GetPlacedBlock(random.NextBelow(numPlacements)));
+        grids[i] = game.GetGrid();
+        lines[i] = game.linesCleared - before;
+    }
+
+    // Every weight non-zero, so every feature takes part in the comparison
+    BotWeights weights = defaultBotWeights;
+    weights.rowTransitions = -0.25;
+
+    int numBatches = numBoards / boardBatchSize;
+    BoardBatch* batches = new BoardBatch[numBatches];
+    for (int i = 0; i < numBoards; i++)
+    {
+        batches[i / boardBatchSize].Add(grids[i], lines[i]);
+    }
+    double* perBoard = new double[numBoards];
+    double* scalar = new double[numBoards];
+    double* avx2 = new double[numBoards];
+    BoardFeatures features;
+    BoardFeatures avx2Features;
+
+    // The paths must agree before they are compared
+    bool hasAvx2 = IsAvx2Available();
+    for (int i = 0; i < numBoards; i++)
+    {
+        perBoard[i] = EvaluateBoard(grids[i], lines[i], weights);
+    }
+    for (int batch = 0; batch < numBatches; batch++)
+    {
+        EvaluateBatchScalar(batches[batch], features);
+        ScoreBatch(batches[batch], features, weights, scalar + batch * boardBatchSize);
+        if (hasAvx2)
+        {
+            EvaluateBatchAvx2(batches[batch], avx2Features);
+            if (memcmp(&features, &avx2Features, sizeof(features)) != 0)
+            {
+                fprintf(stderr, "the AVX2 and scalar kernels disagree on batch %d\n", batch);
+                return 1;
+            }
+        }
+    }
+    for (int i = 0; i < numBoards; i++)
+    {
+        if (scalar[i] != perBoard[i])
+        {
+            fprintf(stderr, "board %d: batched score %f, per-board score %f\n", i, scalar[i], perBoard[i]);
+            return 1;
+        }
+    }
+
+    double checksum = 0; // Keeps the timed passes from being optimized away
+    double perBoardNs = TimeBoards(numBoards, rounds, [&] {
+        for (int i = 0; i < numBoards; i++)
+        {
+            perBoard[i] = EvaluateBoard(grids[i], lines[i], weights);
+        }
+        checksum += perBoard[numBoards - 1];
+    });
+    double scalarNs = TimeBoards(numBoards, rounds, [&] {
+        for (int batch = 0; batch < numBatches; batch++)
+        {
+            EvaluateBatchScalar(batches[batch], features);
+            ScoreBatch(batches[batch], features, weights, scalar + batch * boardBatchSize);
+        }
+        checksum += scalar[numBoards - 1];
+    });
+    double avx2Ns = 0;
+    if (hasAvx2)
+    {
+        avx2Ns = TimeBoards(numBoards, rounds, [&] {
+            for (int batch = 0; batch < numBatches; batch++)
+            {
+                EvaluateBatchAvx2(batches[batch], features);
+                ScoreBatch(batches[batch], features, weights, avx2 + batch * boardBatchSize);
+            }
+            checksum += avx2[numBoards - 1];
+        });
+    }
+
+    printf("boards:        %d x %d rounds (seed %llu)\n", numBoards, rounds, (unsigned long long)seed);
+    printf("per board:     %7.2f ns/board\n", perBoardNs);
+    printf("batch scalar:  %7.2f ns/board (%.2fx)\n", scalarNs, perBoardNs / scalarNs);
+    if (hasAvx2)
+    {
+        printf("batch AVX2:    %7.2f ns/board (%.2fx)\n", avx2Ns, perBoardNs / avx2Ns);
+    }
+    else
+    {
+        printf("batch AVX2:    not available on this build or processor\n");
+    }
+    printf("checksum:      %.3f\n", checksum);
+    delete[] avx2;
+    delete[] scalar;
+    delete[] perBoard;
+    delete[] batches;
+    delete[] lines;
+    delete[] grids;
+    return 0;
+}
@@ -0,0 +1,56 @@
+// Headless runner: plays scripted games on the core rules without a window or audio device
+// and reports the throughput in piece placements per second
+#include "game.h"        // Includes the headless Game rules
+#include "allocations.h" // Includes the allocation counter used to check the hot path
+#include <chrono>  // Includes the clock used to time the run
+#include <cstdio>  // Includes printf for the report
+#include <cstdlib> // Includes atoll and abs
+
+int main(int argc, char** argv)
+{
+    long long placements = argc > 1 ? atoll(argv[1]) : 10000000; // Number of blocks to place
+    unsigned int state = 2463534242u; // Xorshift state for choosing where each block goes
+
+    Game game; // Constructed before counting so startup allocations are excluded
+    long long games = 1; // Number of games played, including the current one
+    long long totalScore = 0; // Sum of the final scores
+
+    long long allocationsBefore = GetAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (long long placed = 0; placed < placements; placed++) // Place one block per iteration
+    {
+        state ^= state << 13; // Advance the xorshift generator
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        int turns = state & 3; // Pick a rotation
+        int shift = (int)((state >> 2) % 11) - 5; // Pick a horizontal move between -5 and 5
+        for (int turn = 0; turn < turns; turn++)
+        {
+            game.ApplyInput(INPUT_ROTATE);
+        }
+        for (int step = 0; step < abs(shift); step++)
+        {
+            game.ApplyInput(shift < 0 ? INPUT_LEFT : INPUT_RIGHT);
+        }
+        game.ApplyInput(INPUT_DROP); // Drop and lock the block
+
+        if (game.gameOver) // The stack reached the top
+        {
+            totalScore += game.score;
+            game.Reset(); // Start the next game
+            games++;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    long long allocations = GetAllocationCount() - allocationsBefore;
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("placements:        %lld\n", placements);
+    printf("games:             %lld\n", games);
+    printf("average score:     %.1f\n", (double)totalScore / games);
+    printf("time:              %.3f s\n", seconds);
+    printf("throughput:        %.2f M placements/s\n", placements / seconds / 1e6);
+    printf("allocations:       %lld\n", allocations);
+    return allocations == 0 ? 0 : 1; // The hot path must not allocate after startup
+}
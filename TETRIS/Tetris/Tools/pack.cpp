@@ -0,0 +1,48 @@
+// Asset packer: packs the game's fonts, images and sounds into one file the game maps at startup
+// Usage: tetris_pack OUTPUT ROOT [DIR...]    packs the files under ROOT/DIR (Font, Image and Sounds by default)
+//        tetris_pack --list PACK             lists a pack's assets
+// The same files always give the same pack, byte for byte
+#include "assetpack.h" // Includes the pack reader and writer
+#include <cstdio>      // Includes printf for the listing
+#include <cstring>     // Includes strcmp for the arguments
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--list") == 0)
+    {
+        AssetPack pack;
+        if (!pack.Open(argv[2]))
+        {
+            fprintf(stderr, "%s is not a readable asset pack\n", argv[2]);
+            return 1;
+        }
+        for (int i = 0; i < pack.GetNumAssets(); i++)
+        {
+            printf("%10zu  %s\n", pack.GetAsset(i).size, pack.GetAsset(i).name.c_str());
+        }
+        return 0;
+    }
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: tetris_pack OUTPUT ROOT [DIR...] | tetris_pack --list PACK\n");
+        return 2;
+    }
+
+    std::vector<std::string> dirs;
+    for (int i = 3; i < argc; i++)
+    {
+        dirs.push_back(argv[i]);
+    }
+    if (dirs.empty())
+    {
+        dirs = { "Font", "Image", "Sounds" };
+    }
+    std::vector<std::string> names;
+    if (!WriteAssetPack(argv[1], argv[2], dirs, &names))
+    {
+        fprintf(stderr, "cannot pack %s into %s\n", argv[2], argv[1]);
+        return 1;
+    }
+    printf("packed %zu assets into %s\n", names.size(), argv[1]);
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Perft: counts the leaves of the placement tree, like chess perft counts move paths
+// Every node is a game state; its children are the placements the move generator finds for the current block,
+// with the blocks dealt by the seeded bag. The counts are a correctness oracle for the grid, the piece table
+// and the move generator, and the time is a repeatable throughput benchmark
+// Usage: tetris_perft [--board FILE] [--seed N] [--depth N] [--threads N] [--hash MB] [--divide]
+// --hash shares a transposition table of that many megabytes between the threads, so subtrees reached
+// by different placement orders are counted once; the table's hit rate and probe cost are printed
+// The board file holds up to 20 rows of 10 characters, top to bottom, aligned to the bottom of the grid;
+// '.' and ' ' are empty cells, the digits 1 to 7 are cells of that block and any other character is a filled cell
+#include "movegen.h"   // Includes the move generator and the game rules
+#include "scheduler.h" // Includes the work-stealing pool that splits the root placements
+#include "transposition.h" // Includes the table of subtree counts shared by the threads
+#include <chrono>      // Includes the clock for the throughput
+#include <cstdio>      // Includes printf and the board file reading
+#include <cstdlib>     // Includes strtoull and atoi
+#include <cstring>     // Includes strcmp and strlen
+
+const int maxDepth = 16; // Deepest tree the tool searches
+
+// Counts the leaves of the placement tree below a game state, using one generator per remaining level
+// With a table, counts of subtrees two or more levels deep are looked up before being searched
+static long long Perft(const Game& game, int depth, MoveGenerator* generators, TranspositionTable* table, TableStats& stats)
+{
+    MoveGenerator& generator = generators[depth - 1];
+    uint64_t key = 0;
+    if (table != nullptr && depth > 1) // Leaves' parents are counted faster than looked up
+    {
+        key = game.GetHash() ^ (uint64_t)depth * 0x9E3779B97F4A7C15ull; // The same position counts differently per depth
+        TableEntry entry;
+        if (table->Probe(key, entry, stats) && entry.depth == depth)
+        {
+            return entry.value;
+        }
+    }
+    int numPlacements = generator.Generate(game.GetGrid(), game.GetCurrentBlock());
+    if (depth == 1) // Bulk counting: the last level needs no placing
+    {
+        return numPlacements;
+    }
+    long long nodes = 0;
+    for (int i = 0; i < numPlacements; i++)
+    {
+        Game child = game; // Games are plain values, so a child is a copy
+        child.PlaceBlock(generator.GetPlacedBlock(i));
+        if (!child.gameOver) // A topped-out game has no children
+        {
+            nodes += Perft(child, depth - 1, generators, table, stats);
+        }
+    }
+    if (table != nullptr)
+    {
+        table->Store(key, TableEntry{ depth, nodes }, stats);
+    }
+    return nodes;
+}
+
+// Reads a board file into a grid; returns false if the file cannot be read
+static bool LoadBoard(const char* path, Grid& grid)
+{
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    char lines[Grid::numRows][64]; // The file's rows, top to bottom
+    int numLines = 0;
+    char line[64];
+    while (numLines < grid.GetNumRows() && fgets(line, sizeof(line), file) != nullptr)
+    {
+        line[strcspn(line, "\r\n")] = 0; // Drop the line ending
+        strcpy(lines[numLines++], line);
+    }
+    fclose(file);
+    int firstRow = grid.GetNumRows() - numLines; // The rows sit on the bottom of the grid
+    for (int i = 0; i < numLines; i++)
+    {
+        int length = (int)strlen(lines[i]);
+        for (int column = 0; column < grid.GetNumCols() && column < length; column++)
+        {
+            char cell = lines[i][column];
+            if (cell != '.' && cell != ' ')
+            {
+                grid.SetCell(firstRow + i, column, cell >= '1' && cell <= '7' ? cell - '0' : (int)L_BLOCK);
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const char* boardPath = nullptr; // Empty board unless a file is given
+    uint64_t seed = 1; // Seed of the block sequence
+    int depth = 3; // Number of placements along each path
+    int numWorkers = 1; // Single-threaded unless asked
+    bool divide = false; // Print the count below every root placement
+    int hashMegabytes = 0; // No transposition table unless asked
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--divide") == 0)
+        {
+            divide = true;
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--board") == 0)
+        {
+            boardPath = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--depth") == 0)
+        {
+            depth = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--hash") == 0)
+        {
+            hashMegabytes = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0)
+        {
+            numWorkers = atoi(argv[++i]); // 0 = one per core
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (depth < 1 || depth > maxDepth)
+    {
+        fprintf(stderr, "depth must be between 1 and %d\n", maxDepth);
+        return 2;
+    }
+
+    Game game;
+    game.Reset(seed);
+    if (boardPath != nullptr)
+    {
+        Grid board;
+        if (!LoadBoard(boardPath, board))
+        {
+            fprintf(stderr, "cannot read %s\n", boardPath);
+            return 2;
+        }
+        game.LoadGrid(board);
+    }
+    if (game.gameOver)
+    {
+        fprintf(stderr, "the first block does not fit on the board\n");
+        return 1;
+    }
+
+    // One generator per level and worker, allocated up front so the search itself never allocates
+    WorkStealingPool pool(numWorkers);
+    int workers = pool.GetNumWorkers();
+    MoveGenerator* generators = new MoveGenerator[(size_t)workers * maxDepth];
+    MoveGenerator root;
+    int numRoots = root.Generate(game.GetGrid(), game.GetCurrentBlock());
+    long long* rootNodes = new long long[numRoots > 0 ? numRoots : 1]; // Leaves below each root placement
+    TranspositionTable* table = hashMegabytes > 0 ? new TranspositionTable((size_t)hashMegabytes) : nullptr;
+    TableStats* stats = new TableStats[workers]; // One set of counters per worker
+
+    auto start = std::chrono::steady_clock::now();
+    // Each root placement is one task; thieves balance the uneven subtrees
+    pool.ParallelFor(numRoots, 1, [&](long long index, int worker) {
+        if (depth == 1)
+        {
+            rootNodes[index] = 1;
+            return;
+        }
+        Game child = game;
+        child.PlaceBlock(root.GetPlacedBlock((int)index));
+        rootNodes[index] = child.gameOver ? 0 : Perft(child, depth - 1, generators + (size_t)worker * maxDepth, table, stats[worker]);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long nodes = 0;
+    for (int i = 0; i < numRoots; i++)
+    {
+        nodes += rootNodes[i];
+        if (divide) // One line per root placement, in generator order, for diffing two builds
+        {
+            const Placement& placement = root.GetPlacement(i);
+            printf("rotation %d row %3d column %3d inputs %2d: %lld\n", placement.rotation, placement.row,
+                placement.column, placement.numInputs, rootNodes[i]);
+        }
+    }
+    printf("depth:    %d (seed %llu, first block %d)\n", depth, (unsigned long long)seed, game.GetCurrentBlock().id);
+    printf("threads:  %d\n", workers);
+    printf("nodes:    %lld\n", nodes);
+    printf("time:     %.3f s (%.2f M nodes/s)\n", seconds, seconds > 0 ? nodes / seconds / 1e6 : 0.0);
+    if (table != nullptr)
+    {
+        TableStats total;
+        for (int i = 0; i < workers; i++)
+        {
+            total.Add(stats[i]);
+        }
+        printf("hash:     %.1f MB, %llu slots\n", table->GetBytes() / 1048576.0, (unsigned long long)table->GetNumSlots());
+        printf("probes:   %llu (%.1f%% hits, %.2f slots/probe)\n", (unsigned long long)total.probes,
+            100.0 * total.GetHitRate(), total.GetSlotsPerProbe());
+        printf("stores:   %llu (%llu replaced another position)\n", (unsigned long long)total.stores,
+            (unsigned long long)total.replacements);
+    }
+    delete[] stats;
+    delete table;
+    delete[] rootNodes;
+    delete[] generators;
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Replay runner: re-simulates replay files as fast as possible and checks that every game ends as recorded,
+// or records a corpus of bot games to check later builds against
+// Usage: tetris_replay [--repeat N] [--threads N] FILE...
+//        tetris_replay --record DIR [--seeds FIRST:COUNT] [--max-pieces N]
+// The files are memory-mapped, so a corpus is read from the page cache without copies
+// Exits with 1 if any replay is corrupt or ends differently, so a script can gate on it
+#include "bot.h"        // Includes the bot that plays the recorded games
+#include "mappedfile.h" // Includes the memory-mapped replay files
+#include "replay.h"     // Includes the replay recorder, reader and simulator
+#include "scheduler.h"  // Includes the work-stealing pool that spreads the replays over the cores
+#include <chrono>       // Includes the clock for the throughput
+#include <cstdio>       // Includes printf and snprintf
+#include <cstdlib>      // Includes strtoull and atoi
+#include <cstring>      // Includes strcmp
+#include <memory>       // Includes unique_ptr for the mapped files
+
+const double recordFrameSeconds = 1.0 / 90.0; // The game's frame time: one recorded input per frame
+
+// Plays one bot game per seed and writes each replay to DIR/seed_N.trp
+// Gravity ticks at the game's rate, so the replays exercise both kinds of events
+static int RecordCorpus(const char* directory, uint64_t firstSeed, long long numGames, int maxPieces)
+{
+    Bot bot;
+    ReplayRecorder recorder;
+    Game game;
+    GameInput inputs[maxMoveStates];
+    for (long long i = 0; i < numGames; i++)
+    {
+        uint64_t seed = firstSeed + (uint64_t)i;
+        game.Reset(seed);
+        double now = 0; // Simulated clock: one frame per input
+        double lastGravity = 0;
+        recorder.Start(seed, now);
+        while (!game.gameOver && game.blocksPlaced < maxPieces)
+        {
+            if (now - lastGravity >= CalculationInterval(game.score)) // Gravity lands before the bot plans
+            {
+                game.MoveBlockDown();
+                recorder.RecordGravity(now);
+                lastGravity = now;
+                if (game.gameOver)
+                {
+                    break;
+                }
+            }
+            int numInputs = bot.Think(game, inputs, maxMoveStates);
+            if (numInputs == 0) // Nothing fits; dropping ends the game
+            {
+                inputs[numInputs++] = INPUT_DROP;
+            }
+            for (int j = 0; j < numInputs; j++)
+            {
+                now += recordFrameSeconds;
+                game.ApplyInput(inputs[j]);
+                recorder.RecordInput(inputs[j], now);
+            }
+        }
+        recorder.Finish(game);
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/seed_%llu.trp", directory, (unsigned long long)seed);
+        if (!recorder.Save(path))
+        {
+            fprintf(stderr, "cannot write %s\n", path);
+            return 2;
+        }
+        printf("%s: %d blocks, %d lines, %zu bytes\n", path, game.blocksPlaced, game.linesCleared, recorder.GetBytes().size());
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* recordDirectory = nullptr; // Recording mode when set
+    uint64_t firstSeed = 1;
+    long long numGames = 10;
+    int maxPieces = 1000;
+    int repeat = 1; // Passes over the files, for timing small corpora
+    int numWorkers = 0; // One worker per core
+    int firstFile = argc; // Index of the first file argument
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--record") == 0)
+        {
+            recordDirectory = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--seeds") == 0)
+        {
+            char* rest = nullptr;
+            firstSeed = strtoull(argv[++i], &rest, 10);
+            if (*rest == ':')
+            {
+                numGames = atoll(rest + 1);
+            }
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--max-pieces") == 0)
+        {
+            maxPieces = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--repeat") == 0)
+        {
+            repeat = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0)
+        {
+            numWorkers = atoi(argv[++i]);
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+        else
+        {
+            firstFile = i; // Everything from here on is a file
+            break;
+        }
+    }
+
+    if (recordDirectory != nullptr)
+    {
+        return RecordCorpus(recordDirectory, firstSeed, numGames, maxPieces);
+    }
+    int numFiles = argc - firstFile;
+    if (numFiles == 0 || repeat < 1)
+    {
+        fprintf(stderr, "usage: tetris_replay [--repeat N] [--threads N] FILE... | --record DIR [--seeds FIRST:COUNT] [--max-pieces N]\n");
+        return 2;
+    }
+
+    std::unique_ptr<MappedFile[]> files(new MappedFile[numFiles]);
+    for (int i = 0; i < numFiles; i++)
+    {
+        if (!files[i].Open(argv[firstFile + i]))
+        {
+            fprintf(stderr, "cannot map %s\n", argv[firstFile + i]);
+            return 2;
+        }
+    }
+
+    // Every replay of every pass is one task; each worker re-simulates on its own Game
+    WorkStealingPool pool(numWorkers);
+    int workers = pool.GetNumWorkers();
+    std::unique_ptr<Game[]> games(new Game[workers]);
+    std::unique_ptr<long long[]> events(new long long[workers]());
+    std::unique_ptr<ReplayResult[]> results(new ReplayResult[numFiles]);
+    auto start = std::chrono::steady_clock::now();
+    pool.ParallelFor((long long)numFiles * repeat, 1, [&](long long index, int worker) {
+        int file = (int)(index % numFiles);
+        long long numEvents = 0;
+        ReplayResult result = SimulateReplay(files[file].GetData(), files[file].GetSize(), games[worker], numEvents);
+        events[worker] += numEvents;
+        if (index < numFiles) // Every pass gives the same result; keep the first
+        {
+            results[file] = result;
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failures = 0;
+    for (int i = 0; i < numFiles; i++)
+    {
+        if (results[i] != REPLAY_OK)
+        {
+            printf("%s: %s\n", argv[firstFile + i], results[i] == REPLAY_CORRUPT ? "corrupt" : "MISMATCH");
+            failures++;
+        }
+    }
+    long long totalEvents = 0;
+    for (int i = 0; i < workers; i++)
+    {
+        totalEvents += events[i];
+    }
+    long long replays = (long long)numFiles * repeat;
+    printf("replays:  %lld (%d files x %d, %d threads)\n", replays, numFiles, repeat, workers);
+    printf("failed:   %d\n", failures);
+    printf("time:     %.3f s (%.0f replays/s, %.2f M events/s)\n", seconds,
+        seconds > 0 ? replays / seconds : 0.0, seconds > 0 ? totalEvents / seconds / 1e6 : 0.0);
+    return failures > 0 ? 1 : 0;
+}